@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Decodifica a telemetria binária do comando 'stream on' e o dump do 'log dump'.
+
+Lê os quadros COBS (delimitados por 0x00) de uma porta serial ou de um arquivo
+capturado, verifica o CRC e imprime uma linha CSV por amostra. Ao final, mostra
+os contadores de quadros, erros de CRC e pacotes perdidos.
+
+Com --dump, envia 'log dump', decodifica os registros do log da flash (valores
+em delta, ver src/datalog.h) e para no quadro de fim do dump.
+
+Exemplos:
+    python3 telemetry_decode.py --port /dev/ttyACM0 > samples.csv
+    python3 telemetry_decode.py --file capture.bin --summary
+    python3 telemetry_decode.py --port /dev/ttyACM0 --dump > log.csv
+"""
+
+import argparse
+import struct
+import sys
+
+TYPE_ADC_BLOCK = 0x01
+TYPE_LOG_RECORD = 0x02
+TYPE_LOG_END = 0x03
+LOG_VERSION = 1
+LOG_HEADER = struct.Struct("<BBHIII")  # version, channels, count, seq, uptime_ms, period_us
+HEADER = struct.Struct("<BBHIIIIiI")  # type, version, count, seq, block_seq, timestamp, cycle_hz, mv, dropped
+HEADER_V2 = struct.Struct("<BB")      # channels, reserved (a partir da versão 2)
+
+
+def crc16_ccitt(data, seed=0xFFFF):
+    """Mesmo algoritmo de crc16_ccitt() do Zephyr (polinômio 0x1021 refletido)."""
+    crc = seed
+    for byte in data:
+        e = (crc ^ byte) & 0xFF
+        f = (e ^ (e << 4)) & 0xFF
+        crc = ((crc >> 8) ^ (f << 8) ^ (f << 3) ^ (f >> 4)) & 0xFFFF
+    return crc
+
+
+def cobs_decode(frame):
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame) + 1:
+            raise ValueError("invalid COBS frame")
+        out += frame[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def varint(data, pos):
+    """Lê um varint LEB128 com zigzag; retorna (valor, próxima posição)."""
+    z = shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        z |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return (z >> 1) ^ -(z & 1), pos
+
+
+class Decoder:
+    def __init__(self, out, summary_only, dump=False):
+        self.out = out
+        self.summary_only = summary_only
+        self.dump = dump
+        self.done = False
+        self.records = 0
+        self.buf = bytearray()
+        self.frames = 0
+        self.crc_errors = 0
+        self.framing_errors = 0
+        self.lost = 0
+        self.device_dropped = 0
+        self.last_seq = None
+        self.first_cycle = None
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            end = self.buf.find(0)
+            if end < 0:
+                return
+            frame = bytes(self.buf[:end])
+            del self.buf[:end + 1]
+            if frame:
+                self.handle(frame)
+
+    def handle(self, frame):
+        try:
+            packet = cobs_decode(frame)
+        except ValueError:
+            self.framing_errors += 1
+            return
+
+        if len(packet) < 3 or crc16_ccitt(packet[:-2]) != struct.unpack_from("<H", packet, len(packet) - 2)[0]:
+            # Texto do console intercalado com o stream também cai aqui
+            self.crc_errors += 1
+            return
+
+        if self.dump:
+            self.handle_log(packet[:-2])
+            return
+
+        if len(packet) < HEADER.size + 2:
+            self.framing_errors += 1
+            return
+
+        ptype, version, count, seq, block_seq, timestamp, cycle_hz, mv, dropped = HEADER.unpack_from(packet)
+        header_size, channels = HEADER.size, 1
+        if version >= 2:
+            channels, _ = HEADER_V2.unpack_from(packet, HEADER.size)
+            header_size += HEADER_V2.size
+        if ptype != TYPE_ADC_BLOCK or channels == 0 or len(packet) != header_size + 2 * count * channels + 2:
+            self.framing_errors += 1
+            return
+
+        if self.last_seq is not None and seq != self.last_seq + 1:
+            self.lost += (seq - self.last_seq - 1) & 0xFFFFFFFF
+        self.last_seq = seq
+        self.device_dropped = dropped
+        self.frames += 1
+
+        if self.summary_only:
+            return
+
+        # Tempo relativo ao primeiro quadro, a partir do contador de ciclos (32 bits)
+        if self.first_cycle is None:
+            self.first_cycle = timestamp
+        t_us = ((timestamp - self.first_cycle) & 0xFFFFFFFF) * 1e6 / cycle_hz if cycle_hz else 0.0
+        samples = struct.unpack_from("<%dh" % (count * channels), packet, header_size)
+        for index in range(count):
+            for channel in range(channels):
+                raw = samples[index * channels + channel]
+                self.out.write("%d,%d,%.1f,%d,%d,%d,%d\n" % (seq, block_seq, t_us, index, channel, raw, mv))
+
+    def handle_log(self, packet):
+        if packet[0] == TYPE_LOG_END:
+            self.done = True
+            return
+        if packet[0] != TYPE_LOG_RECORD or len(packet) < 5 + LOG_HEADER.size:
+            self.framing_errors += 1
+            return
+
+        record = packet[5:]
+        version, channels, count, seq, uptime_ms, period_us = LOG_HEADER.unpack_from(record)
+        if version != LOG_VERSION or channels == 0:
+            self.framing_errors += 1
+            return
+        self.frames += 1
+        self.records += 1
+
+        pos = LOG_HEADER.size
+        values = list(struct.unpack_from("<%dh" % channels, record, pos))
+        pos += 2 * channels
+        try:
+            for index in range(count):
+                if index > 0:
+                    for channel in range(channels):
+                        delta, pos = varint(record, pos)
+                        values[channel] += delta
+                if not self.summary_only:
+                    t_ms = uptime_ms + index * period_us / 1000.0
+                    for channel in range(channels):
+                        self.out.write("%d,%.1f,%d,%d\n" % (seq + index, t_ms, channel, values[channel]))
+        except IndexError:
+            self.framing_errors += 1  # Registro truncado
+
+    def summary(self):
+        if self.dump:
+            return "records=%d crc_errors=%d framing_errors=%d" % (self.records, self.crc_errors, self.framing_errors)
+        return ("frames=%d lost=%d device_dropped=%d crc_errors=%d framing_errors=%d"
+                % (self.frames, self.lost, self.device_dropped, self.crc_errors, self.framing_errors))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="porta serial (requer pyserial)")
+    source.add_argument("--file", help="arquivo com a captura binária")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--summary", action="store_true", help="imprime apenas os contadores")
+    parser.add_argument("--dump", action="store_true", help="decodifica o dump do log da flash ('log dump')")
+    args = parser.parse_args()
+
+    decoder = Decoder(sys.stdout, args.summary, args.dump)
+    if not args.summary:
+        if args.dump:
+            sys.stdout.write("block_seq,uptime_ms,channel,voltage_mv\n")
+        else:
+            sys.stdout.write("seq,block_seq,time_us,index,channel,raw,voltage_mv\n")
+
+    try:
+        if args.file:
+            with open(args.file, "rb") as f:
+                decoder.feed(f.read())
+        else:
+            import serial
+            with serial.Serial(args.port, args.baud, timeout=1) as port:
+                port.write(b"log dump\r\n" if args.dump else b"stream on\r\n")
+                while not decoder.done:
+                    decoder.feed(port.read(4096))
+    except KeyboardInterrupt:
+        pass
+
+    sys.stderr.write(decoder.summary() + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,278 @@
+#include "adc_acq.h"
+#include "calib.h"
+#include "alarm.h"
+
+BUILD_ASSERT(ADC_NUM_CHANNELS >= 1 && ADC_NUM_CHANNELS <= ADC_MAX_CHANNELS,
+             "zephyr,user io-channels must list 1 to ADC_MAX_CHANNELS channels");
+
+#define ADC_CHANNEL_SPEC(node_id, prop, idx) ADC_DT_SPEC_GET_BY_IDX(node_id, idx)
+
+static const struct adc_dt_spec adc_channels[ADC_NUM_CHANNELS] = {
+    DT_FOREACH_PROP_ELEM_SEP(ADC_USER_NODE, io_channels, ADC_CHANNEL_SPEC, (,))
+};
+
+// Posição de cada canal dentro de uma varredura (o driver converte em ordem crescente de canal):
+static uint8_t adc_channel_slot[ADC_NUM_CHANNELS];
+
+// Amostras de todos os blocos ficam contíguas, pois o driver escreve cada
+// nova varredura logo após a anterior durante toda a sequência:
+static int16_t adc_ring_samples[ADC_RING_BLOCKS * ADC_BLOCK_SAMPLES * ADC_NUM_CHANNELS];
+static struct adc_block adc_ring[ADC_RING_BLOCKS];
+
+K_SEM_DEFINE(adc_block_sem, 0, ADC_RING_BLOCKS); // Conta blocos prontos e ainda não consumidos
+
+static const struct device *acq_dev;
+static struct k_poll_signal acq_done_signal;   // Sinalizado pelo driver ao fim de cada sequência
+static struct adc_acq_stats acq_stats;
+static struct k_spinlock acq_stats_lock;
+static uint32_t acq_block_seq = 0;
+static uint8_t acq_next_block = 0;               // Próximo bloco a ser entregue ao consumidor
+static atomic_t acq_rate_hz = ATOMIC_INIT(ADC_SAMPLE_RATE_HZ); // Taxa pedida pelo comando "rate"
+static uint8_t acq_finish_block = ADC_RING_BLOCKS; // Bloco em que a sequência terminou antes da volta
+static bool acq_restart;                         // Recomeçar na próxima chamada de adc_acq_block_get
+static uint32_t acq_last_sample;                 // Ciclo de clock da varredura anterior
+
+static enum adc_action adc_sampling_cb(const struct device *dev,
+                                       const struct adc_sequence *sequence,
+                                       uint16_t sampling_index);
+
+// Uma sequência percorre o buffer circular inteiro, varrendo todos os canais a
+// cada interval_us (atualizado a partir de acq_rate_hz ao iniciar a sequência):
+static struct adc_sequence_options acq_seq_options = {
+    .interval_us = USEC_PER_SEC / ADC_SAMPLE_RATE_HZ,
+    .callback = adc_sampling_cb,
+    .extra_samplings = ADC_RING_BLOCKS * ADC_BLOCK_SAMPLES - 1,
+};
+
+// Callback chamado pelo driver (em contexto de interrupção) após cada varredura:
+static enum adc_action adc_sampling_cb(const struct device *dev,
+                                       const struct adc_sequence *sequence,
+                                       uint16_t sampling_index)
+{
+    uint32_t now = k_cycle_get_32();
+    enum adc_action action = ADC_ACTION_CONTINUE;
+
+    // Intervalo desde a varredura anterior da mesma sequência (taxa obtida e jitter):
+    if (sampling_index > 0) {
+        uint32_t interval = now - acq_last_sample;
+        k_spinlock_key_t key = k_spin_lock(&acq_stats_lock);
+
+        if (acq_stats.intervals == 0 || interval < acq_stats.interval_min_cyc) {
+            acq_stats.interval_min_cyc = interval;
+        }
+        acq_stats.interval_max_cyc = MAX(acq_stats.interval_max_cyc, interval);
+        acq_stats.interval_sum_cyc += interval;
+        acq_stats.intervals++;
+        k_spin_unlock(&acq_stats_lock, key);
+    }
+    acq_last_sample = now;
+
+    // Alarmes avaliados em cada varredura, com os canais na ordem de io-channels:
+    {
+        const int16_t *raw = &adc_ring_samples[sampling_index * ADC_NUM_CHANNELS];
+        int16_t scan[ADC_NUM_CHANNELS];
+
+        for (int ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+            scan[ch] = raw[adc_channel_slot[ch]];
+        }
+        alarm_scan(scan, now);
+    }
+
+    if (((sampling_index + 1) % ADC_BLOCK_SAMPLES) == 0) {
+        uint8_t index = sampling_index / ADC_BLOCK_SAMPLES;
+        struct adc_block *blk = &adc_ring[index];
+
+        blk->seq = acq_block_seq++;
+        blk->timestamp = now;
+        blk->interval_us = acq_seq_options.interval_us;
+        acq_stats.blocks++;
+
+        // Taxa nova: termina a sequência neste bloco em vez de esperar a volta do buffer
+        if (USEC_PER_SEC / (uint32_t)atomic_get(&acq_rate_hz) != acq_seq_options.interval_us &&
+            index < ADC_RING_BLOCKS - 1) {
+            acq_finish_block = index;
+            action = ADC_ACTION_FINISH;
+        }
+        k_sem_give(&adc_block_sem);
+    }
+
+    return action;
+}
+
+static struct adc_sequence acq_seq = {
+    .options = &acq_seq_options,
+    .buffer = adc_ring_samples,
+    .buffer_size = sizeof(adc_ring_samples),
+    .resolution = ADC_RESOLUTION,
+    .oversampling = 0, // O ADC do STM32F4 não tem sobreamostragem em hardware; a decimação é feita por bloco
+};
+
+int adc_acq_init(void)
+{
+    uint32_t mask = 0;
+    int ret;
+
+    acq_dev = adc_channels[0].dev;
+    if (!device_is_ready(acq_dev)) {
+        return -ENODEV;
+    }
+
+    for (int i = 0; i < ADC_NUM_CHANNELS; i++) {
+        const struct adc_dt_spec *spec = &adc_channels[i];
+
+        // Uma única sequência: mesmo controlador e mesma resolução para todos os canais,
+        // e mesmo ganho e referência (uma só tabela de calibração)
+        if (spec->dev != acq_dev || spec->resolution != ADC_RESOLUTION ||
+            spec->channel_cfg.gain != adc_channels[0].channel_cfg.gain ||
+            spec->vref_mv != adc_channels[0].vref_mv || (mask & BIT(spec->channel_id))) {
+            return -EINVAL;
+        }
+
+        ret = adc_channel_setup_dt(spec);
+        if (ret < 0) {
+            return ret;
+        }
+        mask |= BIT(spec->channel_id);
+    }
+
+    for (int i = 0; i < ADC_NUM_CHANNELS; i++) {
+        adc_channel_slot[i] = POPCOUNT(mask & BIT_MASK(adc_channels[i].channel_id));
+    }
+    acq_seq.channels = mask;
+
+    k_poll_signal_init(&acq_done_signal);
+
+    for (int i = 0; i < ADC_RING_BLOCKS; i++) {
+        adc_ring[i].samples = &adc_ring_samples[i * ADC_BLOCK_SAMPLES * ADC_NUM_CHANNELS];
+        adc_ring[i].count = ADC_BLOCK_SAMPLES;
+        adc_ring[i].channels = ADC_NUM_CHANNELS;
+    }
+
+    return 0;
+}
+
+const struct adc_dt_spec *adc_acq_channel(uint8_t ch)
+{
+    return &adc_channels[ch];
+}
+
+int adc_acq_start(void)
+{
+    int ret;
+
+    acq_next_block = 0;
+    acq_finish_block = ADC_RING_BLOCKS;
+    k_sem_reset(&adc_block_sem);
+    k_poll_signal_reset(&acq_done_signal);
+
+    // Nenhuma sequência em andamento: aplica a taxa pedida e zera as medições da anterior
+    if (USEC_PER_SEC / (uint32_t)atomic_get(&acq_rate_hz) != acq_seq_options.interval_us) {
+        k_spinlock_key_t key = k_spin_lock(&acq_stats_lock);
+
+        acq_seq_options.interval_us = USEC_PER_SEC / (uint32_t)atomic_get(&acq_rate_hz);
+        acq_stats.intervals = 0;
+        acq_stats.interval_sum_cyc = 0;
+        acq_stats.interval_max_cyc = 0;
+        k_spin_unlock(&acq_stats_lock, key);
+    }
+
+    ret = adc_read_async(acq_dev, &acq_seq, &acq_done_signal);
+    if (ret < 0) {
+        acq_stats.errors++;
+        return ret;
+    }
+
+    acq_stats.restarts++;
+    return 0;
+}
+
+struct adc_block *adc_acq_block_get(k_timeout_t timeout)
+{
+    struct adc_block *blk;
+    unsigned int signaled;
+    int result;
+    int ret;
+
+    // A sequência terminou antes da volta para trocar a taxa, e o último bloco já foi liberado:
+    if (acq_restart) {
+        acq_restart = false;
+        ret = adc_acq_start();
+        if (ret < 0) {
+            printk("ADC stream restart error: %d\n", ret);
+        }
+    }
+
+    if (k_sem_take(&adc_block_sem, timeout) != 0) {
+        // Sequência interrompida por erro do driver: recomeça a aquisição
+        k_poll_signal_check(&acq_done_signal, &signaled, &result);
+        if (signaled && result < 0) {
+            acq_stats.errors++;
+            adc_acq_start();
+        }
+        return NULL;
+    }
+
+    blk = &adc_ring[acq_next_block++];
+
+    // Sequência encerrada pela troca de taxa: a próxima começa pelo bloco 0,
+    // então só recomeça quando o consumidor terminar este bloco.
+    if (acq_next_block - 1 == acq_finish_block) {
+        acq_restart = true;
+        return blk;
+    }
+
+    // Último bloco da volta: os anteriores já foram consumidos, então a próxima
+    // sequência pode começar enquanto o consumidor processa este bloco.
+    if (acq_next_block == ADC_RING_BLOCKS) {
+        ret = adc_acq_start();
+        if (ret < 0) {
+            printk("ADC stream restart error: %d\n", ret);
+        }
+    }
+
+    return blk;
+}
+
+void adc_acq_block_channel(const struct adc_block *blk, uint8_t ch, int16_t *out)
+{
+    const int16_t *in = &blk->samples[adc_channel_slot[ch]];
+
+    for (int i = 0; i < blk->count; i++) {
+        out[i] = in[i * blk->channels];
+    }
+}
+
+int adc_acq_to_mv(uint8_t ch, const int16_t *samples, uint16_t count, int32_t *voltage_mv)
+{
+    if (acq_dev == NULL) {
+        return -ENODEV;
+    }
+
+    // Uma leitura da tabela por amostra, sem conversão em tempo de execução:
+    *voltage_mv = calib_block_mv(samples, count);
+
+    return 0;
+}
+
+void adc_acq_stats_get(struct adc_acq_stats *stats)
+{
+    k_spinlock_key_t key = k_spin_lock(&acq_stats_lock);
+
+    *stats = acq_stats;
+    k_spin_unlock(&acq_stats_lock, key);
+}
+
+int adc_acq_rate_set(uint32_t hz)
+{
+    if (hz < ADC_RATE_MIN_HZ || hz > ADC_RATE_MAX_HZ) {
+        return -EINVAL;
+    }
+
+    atomic_set(&acq_rate_hz, hz);
+    return 0;
+}
+
+uint32_t adc_acq_rate_get(void)
+{
+    return atomic_get(&acq_rate_hz);
+}
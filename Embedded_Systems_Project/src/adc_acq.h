@@ -0,0 +1,60 @@
+#ifndef ADC_ACQ_H
+#define ADC_ACQ_H
+
+#include "config.h"
+
+// Bloco de amostras produzido pela aquisição contínua do ADC:
+struct adc_block {
+    uint32_t seq;        // Número sequencial do bloco (cresce sem reiniciar)
+    uint32_t timestamp;  // Ciclo de clock (k_cycle_get_32) em que a última amostra foi convertida
+    uint16_t count;      // Varreduras no bloco (amostras por canal)
+    uint8_t channels;    // Amostras por varredura
+    uint32_t interval_us; // Intervalo programado entre varreduras (comando "rate")
+    int16_t *samples;    // Amostras brutas intercaladas: count varreduras de channels amostras,
+                         // em ordem crescente de número de canal do ADC
+};
+
+// Estatísticas da aquisição:
+struct adc_acq_stats {
+    uint32_t blocks;     // Blocos concluídos
+    uint32_t restarts;   // Sequências iniciadas (uma por volta do buffer circular)
+    uint32_t errors;     // Falhas ao iniciar ou concluir uma sequência
+    // Intervalos medidos entre varreduras desde a última mudança de taxa
+    // (taxa obtida e jitter; a pausa entre sequências não conta):
+    uint32_t intervals;
+    uint64_t interval_sum_cyc;
+    uint32_t interval_min_cyc;
+    uint32_t interval_max_cyc;
+};
+
+// Configura os canais do devicetree e prepara o buffer circular:
+int adc_acq_init(void);
+
+// Canal de índice ch na lista io-channels:
+const struct adc_dt_spec *adc_acq_channel(uint8_t ch);
+
+// Inicia a conversão contínua a partir do primeiro bloco do buffer circular:
+int adc_acq_start(void);
+
+// Aguarda o próximo bloco completo. O bloco permanece válido até a próxima chamada.
+// Retorna NULL se nenhum bloco ficar pronto dentro do timeout.
+struct adc_block *adc_acq_block_get(k_timeout_t timeout);
+
+// Copia as amostras de um canal (índice na lista io-channels) para um vetor contíguo:
+void adc_acq_block_channel(const struct adc_block *blk, uint8_t ch, int16_t *out);
+
+// Média de count amostras de um canal em mV, pela tabela de calibração (src/calib.h).
+// A tabela guarda frações de mV, então a média mantém os bits ganhos na decimação.
+int adc_acq_to_mv(uint8_t ch, const int16_t *samples, uint16_t count, int32_t *voltage_mv);
+
+void adc_acq_stats_get(struct adc_acq_stats *stats);
+
+// Taxa de varredura em Hz (ADC_RATE_MIN_HZ a ADC_RATE_MAX_HZ). A sequência em
+// andamento termina no fim do bloco atual e a próxima já usa o novo intervalo.
+int adc_acq_rate_set(uint32_t hz);
+
+// Taxa pedida. O intervalo é USEC_PER_SEC / hz, arredondado pelo timer do driver
+// para ticks inteiros: a taxa obtida vem dos intervalos em adc_acq_stats.
+uint32_t adc_acq_rate_get(void);
+
+#endif /* ADC_ACQ_H */
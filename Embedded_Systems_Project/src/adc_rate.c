@@ -0,0 +1,127 @@
+#include "adc_acq.h"
+#include "bus.h"
+#include "cmd.h"
+#include "uart_io.h"
+#include <stdlib.h>
+
+// Taxa de amostragem em tempo de execução: "rate <hz>" fixa a taxa e "rate auto"
+// deixa o listener abaixo ajustá-la pela variação do sinal entre blocos. A nova
+// taxa vale a partir do fim do bloco em andamento (veja adc_acq_rate_set).
+
+static atomic_t rate_auto = ATOMIC_INIT(0);
+
+// Estado do modo automático (só a adc_thread acessa):
+static int32_t rate_prev_mv[ADC_NUM_CHANNELS];
+static uint32_t rate_prev_seq;
+static uint32_t rate_stable_blocks;
+static uint32_t rate_changes;           // Mudanças feitas pelo modo automático
+
+// Listener do adc_chan (na adc_thread): dobra a taxa quando algum canal varia
+// ADC_AUTO_FAST_MV ou mais entre blocos e a reduz à metade depois de
+// ADC_AUTO_STABLE_BLOCKS blocos seguidos com variação de até ADC_AUTO_STABLE_MV.
+static void rate_adc_cb(const struct zbus_channel *chan)
+{
+    const struct adc_snapshot *snap = zbus_chan_const_msg(chan);
+    uint32_t hz = adc_acq_rate_get();
+    uint32_t next = hz;
+    int32_t delta = 0;
+    bool contiguous = snap->seq == rate_prev_seq + 1;
+
+    bus_observed(chan);
+
+    for (int ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+        delta = MAX(delta, abs(snap->channels[ch].voltage_mv - rate_prev_mv[ch]));
+        rate_prev_mv[ch] = snap->channels[ch].voltage_mv;
+    }
+    rate_prev_seq = snap->seq;
+
+    // Sem comparação válida (primeiro bloco ou lacuna), ou taxa ainda não aplicada:
+    if (!atomic_get(&rate_auto) || !contiguous || snap->interval_us != USEC_PER_SEC / hz) {
+        rate_stable_blocks = 0;
+        return;
+    }
+
+    if (delta >= ADC_AUTO_FAST_MV) {
+        rate_stable_blocks = 0;
+        next = MIN(hz * 2, ADC_AUTO_MAX_HZ);
+    } else if (delta <= ADC_AUTO_STABLE_MV) {
+        if (++rate_stable_blocks >= ADC_AUTO_STABLE_BLOCKS) {
+            rate_stable_blocks = 0;
+            next = MAX(hz / 2, ADC_AUTO_MIN_HZ);
+        }
+    } else {
+        rate_stable_blocks = 0;
+    }
+
+    if (next != hz && adc_acq_rate_set(next) == 0) {
+        rate_changes++;
+    }
+}
+
+ZBUS_LISTENER_DEFINE(rate_adc_lis, rate_adc_cb);
+ZBUS_CHAN_ADD_OBS(adc_chan, rate_adc_lis, 5);
+
+static void rate_print(void)
+{
+    struct adc_acq_stats acq;
+    uint32_t cyc_hz = sys_clock_hw_cycles_per_sec();
+
+    adc_acq_stats_get(&acq);
+
+    uart_io_printf("\n=== ADC SAMPLE RATE ===\n");
+    if (atomic_get(&rate_auto)) {
+        uart_io_printf("Mode: auto (%u-%u Hz), %u change(s)\n", ADC_AUTO_MIN_HZ, ADC_AUTO_MAX_HZ,
+                       rate_changes);
+    } else {
+        uart_io_printf("Mode: fixed\n");
+    }
+    uart_io_printf("Requested: %u Hz (%u us)\n", adc_acq_rate_get(),
+                   USEC_PER_SEC / adc_acq_rate_get());
+
+    if (acq.intervals == 0) {
+        uart_io_printf("Achieved: no samples yet\n");
+    } else {
+        // Média dos intervalos medidos no callback do ADC, em centésimos de Hz:
+        uint64_t rate_chz = (uint64_t)acq.intervals * cyc_hz * 100 / acq.interval_sum_cyc;
+        uint32_t min_us = k_cyc_to_us_floor32(acq.interval_min_cyc);
+        uint32_t max_us = k_cyc_to_us_floor32(acq.interval_max_cyc);
+
+        uart_io_printf("Achieved: %u.%02u Hz over %u intervals\n", (uint32_t)(rate_chz / 100),
+                       (uint32_t)(rate_chz % 100), acq.intervals);
+        uart_io_printf("Interval: min %u us, max %u us, jitter %u us p-p\n", min_us, max_us,
+                       max_us - min_us);
+    }
+    uart_io_printf("=======================\n\n");
+}
+
+// Comando "rate [<hz>|auto]": mostra a taxa pedida e a obtida, fixa uma taxa ou liga o modo automático
+static int cmd_rate(int argc, char *argv[])
+{
+    uint32_t hz;
+    int ret;
+
+    if (argc == 2 && strcmp(argv[1], "auto") == 0) {
+        rate_stable_blocks = 0;
+        atomic_set(&rate_auto, 1);
+        ret = adc_acq_rate_set(CLAMP(adc_acq_rate_get(), ADC_AUTO_MIN_HZ, ADC_AUTO_MAX_HZ));
+        if (ret < 0) {
+            return ret;
+        }
+    } else if (argc == 2) {
+        if (cmd_parse_u32(argv[1], ADC_RATE_MIN_HZ, ADC_RATE_MAX_HZ, &hz) < 0) {
+            return -EINVAL;
+        }
+        atomic_set(&rate_auto, 0);
+        ret = adc_acq_rate_set(hz);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    rate_print();
+
+    return 0;
+}
+
+APP_CMD_DEFINE(rate, "rate", cmd_rate, "[<hz>|auto]", 0, 1,
+               "Show or set the ADC sample rate (fixed or adaptive)");
@@ -0,0 +1,35 @@
+#include "adc_snapshot.h"
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/barrier.h>
+
+// Duas cópias do valor e um contador de versão (seqlock em "latch"): enquanto o
+// escritor altera uma cópia, a paridade do contador aponta os leitores para a outra.
+// Assim um leitor que interrompe o escritor sempre encontra uma cópia estável e só
+// repete a leitura se o escritor avançar durante a cópia.
+static struct adc_snapshot snapshot_slots[2];
+static atomic_t snapshot_seq = ATOMIC_INIT(0);
+
+void adc_snapshot_publish(const struct adc_snapshot *snap)
+{
+    atomic_inc(&snapshot_seq);          // Ímpar: leitores usam a cópia 1
+    barrier_dmem_fence_full();
+    snapshot_slots[0] = *snap;
+    barrier_dmem_fence_full();
+
+    atomic_inc(&snapshot_seq);          // Par: leitores usam a cópia 0
+    barrier_dmem_fence_full();
+    snapshot_slots[1] = *snap;
+    barrier_dmem_fence_full();
+}
+
+void adc_snapshot_get(struct adc_snapshot *snap)
+{
+    atomic_val_t seq;
+
+    do {
+        seq = atomic_get(&snapshot_seq);
+        barrier_dmem_fence_full();
+        *snap = snapshot_slots[seq & 1];
+        barrier_dmem_fence_full();
+    } while (atomic_get(&snapshot_seq) != seq);
+}
@@ -0,0 +1,35 @@
+#ifndef ADC_SNAPSHOT_H
+#define ADC_SNAPSHOT_H
+
+#include "config.h"
+
+// Valores de um canal do ADC:
+struct adc_channel_value {
+    int32_t voltage_mv;  // Valor filtrado e decimado do bloco
+    int32_t min_mv;      // Menor e maior valor desde o início da aquisição
+    int32_t max_mv;
+    int16_t min_raw;     // Faixa das amostras brutas do bloco (ruído pico a pico)
+    int16_t max_raw;
+    uint16_t raw_q4;     // Média das amostras brutas do bloco em 1/16 de código (comando "cal")
+};
+
+// Último valor publicado pela thread do ADC:
+struct adc_snapshot {
+    int32_t voltage_mv;  // Primeiro canal (potenciômetro)
+    uint8_t percentage;
+    bool ready;          // Falso até a primeira publicação
+    uint32_t seq;        // Número do bloco de amostras que originou o valor
+    uint32_t timestamp;  // Ciclo de clock (k_cycle_get_32) da última amostra do bloco
+    uint32_t published;  // Ciclo de clock em que o valor foi publicado
+    uint32_t interval_us; // Intervalo entre as varreduras do bloco (comando "rate")
+    struct adc_channel_value channels[ADC_NUM_CHANNELS]; // Na ordem da lista io-channels
+};
+
+// Publica um novo valor. Deve haver um único escritor (a thread do ADC).
+void adc_snapshot_publish(const struct adc_snapshot *snap);
+
+// Copia o último valor publicado. Nunca bloqueia e pode ser chamada de qualquer
+// contexto, inclusive interrupções.
+void adc_snapshot_get(struct adc_snapshot *snap);
+
+#endif /* ADC_SNAPSHOT_H */
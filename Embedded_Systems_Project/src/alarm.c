@@ -0,0 +1,304 @@
+#include "alarm.h"
+#include "adc_acq.h"
+#include "calib.h"
+#include "latency.h"
+#include "uart_io.h"
+#include "cmd.h"
+
+#define ALARM_OUT_NODE DT_ALIAS(alarm_out)
+
+enum alarm_state {
+    ALARM_NORMAL,
+    ALARM_HIGH,
+    ALARM_LOW,
+};
+
+static const char *const alarm_state_names[] = {
+    [ALARM_NORMAL] = "CLEAR",
+    [ALARM_HIGH]   = "HIGH",
+    [ALARM_LOW]    = "LOW",
+};
+
+struct alarm_channel {
+    // Configuração (comando "alarm"):
+    int32_t low_mv;
+    int32_t high_mv;
+    int32_t hyst_mv;
+    uint16_t debounce;       // Amostras seguidas para mudar de estado (0 = desligado)
+    // Estado (só o callback do ADC altera):
+    uint8_t state;
+    uint8_t pending;         // Estado candidato e quantas amostras seguidas o confirmam
+    uint16_t count;
+    uint32_t trips;          // Entradas em alarme
+};
+
+// Mudança de estado enviada pelo callback do ADC para a thread de alarmes:
+struct alarm_event {
+    uint32_t sample_cycle;   // Chegada da amostra ao software
+    uint32_t out_cycle;      // GPIO atualizado
+    uint32_t uptime_ms;
+    int32_t mv;
+    uint8_t ch;
+    uint8_t state;
+    uint8_t active;          // Canais em alarme depois desta mudança
+    bool reset;              // Encerrado pelo alarm_set, sem amostra (nem latência)
+};
+
+static const struct gpio_dt_spec alarm_out = GPIO_DT_SPEC_GET_OR(ALARM_OUT_NODE, gpios, {0});
+
+static struct alarm_channel alarm_channels[ADC_NUM_CHANNELS];
+static uint8_t alarm_active;            // Canais em alarme (callback do ADC)
+static uint32_t alarm_dropped;          // Eventos perdidos com a fila cheia
+static struct k_spinlock alarm_lock;    // Configuração x callback do ADC
+
+K_MSGQ_DEFINE(alarm_msgq, sizeof(struct alarm_event), ALARM_EVENT_QUEUE, 4);
+
+K_THREAD_STACK_DEFINE(alarm_stack, 1024);
+static struct k_thread alarm_thread_data;
+
+// Estado candidato para a amostra, com histerese na saída do alarme:
+static uint8_t alarm_classify(const struct alarm_channel *a, int32_t mv)
+{
+    switch (a->state) {
+    case ALARM_HIGH:
+        if (mv >= a->high_mv - a->hyst_mv) {
+            return ALARM_HIGH;
+        }
+        break;
+    case ALARM_LOW:
+        if (mv <= a->low_mv + a->hyst_mv) {
+            return ALARM_LOW;
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (mv > a->high_mv) {
+        return ALARM_HIGH;
+    }
+    if (mv < a->low_mv) {
+        return ALARM_LOW;
+    }
+    return ALARM_NORMAL;
+}
+
+void alarm_scan(const int16_t *scan, uint32_t cycle)
+{
+    k_spinlock_key_t key = k_spin_lock(&alarm_lock);
+
+    for (uint8_t ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+        struct alarm_channel *a = &alarm_channels[ch];
+        struct alarm_event ev;
+        int32_t mv;
+        uint8_t next;
+
+        if (a->debounce == 0) {
+            continue;
+        }
+
+        mv = calib_sample_mv(scan[ch]);
+        next = alarm_classify(a, mv);
+
+        // Debounce: o mesmo estado novo em debounce amostras seguidas
+        if (next == a->state) {
+            a->count = 0;
+            continue;
+        }
+        if (next != a->pending) {
+            a->pending = next;
+            a->count = 0;
+        }
+        if (++a->count < a->debounce) {
+            continue;
+        }
+
+        if (a->state == ALARM_NORMAL) {
+            alarm_active++;
+            a->trips++;
+        } else if (next == ALARM_NORMAL) {
+            alarm_active--;
+        }
+        a->state = next;
+        a->count = 0;
+
+        // Saída atualizada aqui mesmo, sem esperar nenhuma thread:
+        if (alarm_out.port != NULL) {
+            gpio_pin_set_dt(&alarm_out, alarm_active > 0);
+        }
+
+        ev = (struct alarm_event){
+            .sample_cycle = cycle,
+            .out_cycle = k_cycle_get_32(),
+            .uptime_ms = k_uptime_get_32(),
+            .mv = mv,
+            .ch = ch,
+            .state = next,
+            .active = alarm_active,
+        };
+        latency_record(LAT_ALARM_GPIO, ev.out_cycle - cycle);
+        if (k_msgq_put(&alarm_msgq, &ev, K_NO_WAIT) < 0) {
+            alarm_dropped++;
+        }
+    }
+
+    k_spin_unlock(&alarm_lock, key);
+}
+
+// Thread de alarmes: LED (pisca enquanto houver alarme, depois volta ao último
+// estado pedido pelos comandos) e relatório na UART.
+static void alarm_thread(void *a, void *b, void *c)
+{
+    bool blinking = false;
+    struct alarm_event ev;
+
+    while (1) {
+        k_msgq_get(&alarm_msgq, &ev, K_FOREVER);
+
+        if (ev.active > 0 && !blinking) {
+            led_alarm(true);
+            blinking = true;
+        } else if (ev.active == 0 && blinking) {
+            led_alarm(false);
+            blinking = false;
+        }
+
+        // Mudança de configuração: não veio de uma amostra, fica fora dos histogramas
+        if (ev.reset) {
+            uart_io_printf("ALARM,%u,%u,RESET\n", ev.uptime_ms, ev.ch);
+            continue;
+        }
+        latency_record(LAT_ALARM_LED, k_cycle_get_32() - ev.sample_cycle);
+
+        uart_io_printf("ALARM,%u,%u,%s,%d,%u\n", ev.uptime_ms, ev.ch, alarm_state_names[ev.state],
+                       ev.mv, k_cyc_to_us_floor32(ev.out_cycle - ev.sample_cycle));
+    }
+}
+
+int alarm_init(void)
+{
+    int ret;
+
+    if (alarm_out.port != NULL) {
+        if (!gpio_is_ready_dt(&alarm_out)) {
+            return -ENODEV;
+        }
+        ret = gpio_pin_configure_dt(&alarm_out, GPIO_OUTPUT_INACTIVE);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    k_thread_create(&alarm_thread_data, alarm_stack, K_THREAD_STACK_SIZEOF(alarm_stack),
+                    alarm_thread, NULL, NULL, NULL, ALARM_PRIORITY, 0, K_NO_WAIT);
+    k_thread_name_set(&alarm_thread_data, "alarm");
+
+    return 0;
+}
+
+int alarm_set(uint8_t ch, int32_t low_mv, int32_t high_mv, int32_t hyst_mv, uint16_t debounce)
+{
+    struct alarm_channel *a;
+    k_spinlock_key_t key;
+
+    if (ch >= ADC_NUM_CHANNELS || (debounce > 0 && (low_mv > high_mv || hyst_mv < 0))) {
+        return -EINVAL;
+    }
+
+    // O canal recomeça no estado normal (um alarme ativo é encerrado com um evento CLEAR):
+    key = k_spin_lock(&alarm_lock);
+    a = &alarm_channels[ch];
+    if (a->state != ALARM_NORMAL) {
+        struct alarm_event ev = {
+            .uptime_ms = k_uptime_get_32(),
+            .ch = ch,
+            .state = ALARM_NORMAL,
+            .reset = true,
+        };
+
+        alarm_active--;
+        if (alarm_out.port != NULL) {
+            gpio_pin_set_dt(&alarm_out, alarm_active > 0);
+        }
+        ev.active = alarm_active;
+        if (k_msgq_put(&alarm_msgq, &ev, K_NO_WAIT) < 0) {
+            alarm_dropped++;
+        }
+    }
+    a->low_mv = low_mv;
+    a->high_mv = high_mv;
+    a->hyst_mv = hyst_mv;
+    a->debounce = debounce;
+    a->state = ALARM_NORMAL;
+    a->pending = ALARM_NORMAL;
+    a->count = 0;
+    k_spin_unlock(&alarm_lock, key);
+
+    return 0;
+}
+
+static void alarm_print(void)
+{
+    uint32_t interval_us = USEC_PER_SEC / adc_acq_rate_get();
+
+    uart_io_printf("\n=== ALARMS ===\n");
+    uart_io_printf("Output: %s, active channels: %u, dropped events: %u\n",
+                   alarm_out.port != NULL ? alarm_out.port->name : "none (no alarm-out alias)",
+                   alarm_active, alarm_dropped);
+    uart_io_printf("%-3s %6s %6s %6s %8s %-6s %6s\n", "Ch", "Low", "High", "Hyst", "Debounce",
+                   "State", "Trips");
+    for (uint8_t ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+        const struct alarm_channel *a = &alarm_channels[ch];
+
+        if (a->debounce == 0) {
+            uart_io_printf("%-3u %6s\n", ch, "off");
+            continue;
+        }
+        uart_io_printf("%-3u %6d %6d %6d %8u %-6s %6u\n", ch, a->low_mv, a->high_mv, a->hyst_mv,
+                       a->debounce, alarm_state_names[a->state], a->trips);
+    }
+    uart_io_printf("Sample period: %u us (see 'latency' for sample->gpio/led)\n", interval_us);
+    uart_io_printf("==============\n\n");
+}
+
+// Comando "alarm [<ch> off | <ch> <low> <high> [hyst] [debounce]]" (mV e amostras):
+static int cmd_alarm(int argc, char *argv[])
+{
+    uint32_t ch;
+    uint32_t low;
+    uint32_t high;
+    uint32_t hyst = ALARM_HYST_MV;
+    uint32_t debounce = ALARM_DEBOUNCE;
+    int ret;
+
+    if (argc == 1) {
+        alarm_print();
+        return 0;
+    }
+
+    if (cmd_parse_u32(argv[1], 0, ADC_NUM_CHANNELS - 1, &ch) < 0) {
+        return -EINVAL;
+    }
+
+    if (argc == 3 && strcmp(argv[2], "off") == 0) {
+        ret = alarm_set(ch, 0, 0, 0, 0);
+    } else {
+        if (argc < 4 || cmd_parse_u32(argv[2], 0, ALARM_MAX_MV, &low) < 0 ||
+            cmd_parse_u32(argv[3], low, ALARM_MAX_MV, &high) < 0 ||
+            (argc > 4 && cmd_parse_u32(argv[4], 0, ALARM_MAX_MV, &hyst) < 0) ||
+            (argc > 5 && cmd_parse_u32(argv[5], 1, UINT16_MAX, &debounce) < 0)) {
+            return -EINVAL;
+        }
+        ret = alarm_set(ch, low, high, hyst, debounce);
+    }
+    if (ret < 0) {
+        return ret;
+    }
+
+    alarm_print();
+
+    return 0;
+}
+
+APP_CMD_DEFINE(alarm, "alarm", cmd_alarm, "[<ch> off|<ch> <low> <high> [hyst] [debounce]]", 0, 5,
+               "Show or set per-channel threshold alarms");
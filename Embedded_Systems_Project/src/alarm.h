@@ -0,0 +1,32 @@
+#ifndef ALARM_H
+#define ALARM_H
+
+#include "config.h"
+
+// Alarmes de limite por canal, avaliados a cada varredura dentro do callback do
+// ADC (antes de qualquer thread): a amostra passa pela tabela de calibração e é
+// comparada com os limites. Um canal entra em alarme depois de debounce
+// amostras seguidas acima de high_mv (ou abaixo de low_mv) e só volta ao normal
+// depois de debounce amostras hyst_mv para dentro do limite.
+//
+// Qualquer canal em alarme liga o GPIO alarm-out (alias opcional no devicetree)
+// no mesmo callback. A thread de alarmes põe o LED para piscar (led_alarm)
+// enquanto houver alarme, depois volta ao último estado pedido pelos comandos
+// do LED (inclusive os recebidos durante o alarme), e imprime cada mudança na UART:
+//   ALARM,<uptime_ms>,<canal>,<HIGH|LOW|CLEAR>,<mV>,<amostra -> GPIO em us>
+// Um alarme ativo encerrado por alarm_set (nova configuração) sai como
+//   ALARM,<uptime_ms>,<canal>,RESET
+// sem tensão nem latência, pois não veio de uma amostra.
+// As latências amostra -> GPIO e amostra -> LED vão para o comando "latency".
+
+// Configura o GPIO e cria a thread de eventos:
+int alarm_init(void);
+
+// Limites de um canal (índice na lista io-channels); debounce 0 desliga o alarme:
+int alarm_set(uint8_t ch, int32_t low_mv, int32_t high_mv, int32_t hyst_mv, uint16_t debounce);
+
+// Chamada pelo callback do ADC (interrupção) com uma varredura na ordem de
+// io-channels e o ciclo de clock em que ela chegou ao software:
+void alarm_scan(const int16_t *scan, uint32_t cycle);
+
+#endif /* ALARM_H */
@@ -0,0 +1,113 @@
+#include "bench.h"
+#include "adc_acq.h"
+#include "text_display.h"
+#include "uart_io.h"
+#include "cmd.h"
+
+void bench_report(const char *name, uint32_t ops, uint32_t cycles)
+{
+    uint64_t ns = k_cyc_to_ns_floor64(cycles);
+
+    uart_io_printf("BENCH,%s,%u,%u,%u\n", name, ops, cycles, (uint32_t)(ns / MAX(ops, 1U)));
+}
+
+// Conversão de um bloco sintético (rampa) pelo mesmo caminho da adc_thread:
+static void bench_adc(uint32_t iterations)
+{
+    static int16_t samples[ADC_BLOCK_SAMPLES];
+    int32_t voltage_mv;
+    uint32_t start;
+    uint32_t cycles;
+
+    for (int i = 0; i < ADC_BLOCK_SAMPLES; i++) {
+        samples[i] = (i * 64) & BIT_MASK(ADC_RESOLUTION);
+    }
+
+    start = k_cycle_get_32();
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (adc_acq_to_mv(0, samples, ADC_BLOCK_SAMPLES, &voltage_mv) < 0) {
+            uart_io_printf("BENCH,adc_block_mv,skipped (ADC not started)\n");
+            return;
+        }
+    }
+    cycles = k_cycle_get_32() - start;
+
+    bench_report("adc_block_mv", iterations, cycles);
+}
+
+// Quadro completo do display, alternando o status do LED para sempre haver campo alterado.
+// O próximo quadro da display_thread restaura o status real.
+static void bench_display(uint32_t iterations)
+{
+    uint32_t frames = MAX(iterations / 10, 1U);
+    uint32_t start;
+    uint32_t cycles;
+
+    start = k_cycle_get_32();
+    for (uint32_t i = 0; i < frames; i++) {
+        display_update_status((i & 1) ? "ON" : "OFF");
+    }
+    cycles = k_cycle_get_32() - start;
+
+    bench_report("display_update_status", frames, cycles);
+}
+
+// Busca de todos os comandos registrados na tabela hash, mais a conversão de argumento:
+static void bench_cmd(uint32_t iterations)
+{
+    uint32_t lookups = 0;
+    uint32_t value;
+    uint32_t start;
+    uint32_t cycles;
+
+    start = k_cycle_get_32();
+    for (uint32_t i = 0; i < iterations; i++) {
+        STRUCT_SECTION_FOREACH(app_cmd, cmd) {
+            if (cmd_find(cmd->name) == cmd) {
+                lookups++;
+            }
+        }
+    }
+    cycles = k_cycle_get_32() - start;
+    bench_report("cmd_find", lookups, cycles);
+
+    start = k_cycle_get_32();
+    for (uint32_t i = 0; i < iterations; i++) {
+        cmd_parse_u32("4096", 0, UINT32_MAX, &value);
+    }
+    cycles = k_cycle_get_32() - start;
+    bench_report("cmd_parse_u32", iterations, cycles);
+}
+
+void bench_run(uint32_t iterations)
+{
+    uart_io_printf("\n=== BENCHMARK (%u iterations) ===\n", iterations);
+    uart_io_printf("BENCH,name,ops,cycles,ns_per_op\n");
+
+    // A superfície de texto é compartilhada com a display_thread:
+    k_mutex_lock(&display_mutex, K_FOREVER);
+    text_display_bench(iterations);
+    bench_display(iterations);
+    k_mutex_unlock(&display_mutex);
+
+    bench_adc(iterations);
+    bench_cmd(iterations);
+
+    uart_io_printf("BENCH_DONE\n");
+}
+
+// Comando "bench [iterations]":
+static int cmd_bench(int argc, char *argv[])
+{
+    uint32_t iterations = BENCH_ITERATIONS;
+
+    if (argc > 1 && cmd_parse_u32(argv[1], 1, 100000, &iterations) < 0) {
+        return -EINVAL;
+    }
+
+    bench_run(iterations);
+    return 0;
+}
+
+APP_CMD_DEFINE(bench, "bench", cmd_bench, "[iterations]", 0, 1,
+               "Benchmark rendering, ADC conversion and command lookup");
@@ -0,0 +1,13 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "config.h"
+
+// Imprime uma linha de resultado em formato CSV, lida pelo twister (sample.yaml):
+// BENCH,<nome>,<operações>,<ciclos>,<ns por operação>
+void bench_report(const char *name, uint32_t ops, uint32_t cycles);
+
+// Executa todos os benchmarks dos caminhos críticos e termina com "BENCH_DONE":
+void bench_run(uint32_t iterations);
+
+#endif /* BENCH_H */
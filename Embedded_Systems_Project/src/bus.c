@@ -0,0 +1,102 @@
+#include "bus.h"
+#include "uart_io.h"
+
+// Contadores de cada canal (user_data do zbus). Publicação e notificação
+// acontecem com o canal travado, então os campos não precisam de outra trava.
+struct bus_stats {
+    uint32_t publishes;
+    uint32_t notifies;        // Listeners executados
+    atomic_t claim_failures;  // Publicações perdidas por timeout do canal
+    uint32_t published_at;    // Ciclo de clock da última publicação
+    uint64_t obs_sum_us;      // Latência publicação -> início do listener
+    uint32_t obs_max_us;
+};
+
+static struct bus_stats adc_chan_stats;
+static struct bus_stats led_chan_stats;
+static struct bus_stats cmd_chan_stats;
+
+ZBUS_CHAN_DEFINE(adc_chan, struct adc_snapshot, NULL, &adc_chan_stats, ZBUS_OBSERVERS_EMPTY,
+                 ZBUS_MSG_INIT(0));
+
+ZBUS_CHAN_DEFINE(led_chan, struct led_state_msg, NULL, &led_chan_stats, ZBUS_OBSERVERS_EMPTY,
+                 ZBUS_MSG_INIT(.mode = LED_MODE_OFF));
+
+ZBUS_CHAN_DEFINE(cmd_chan, struct cmd_event_msg, NULL, &cmd_chan_stats, ZBUS_OBSERVERS_EMPTY,
+                 ZBUS_MSG_INIT(.cmd = NULL));
+
+void *bus_claim(const struct zbus_channel *chan)
+{
+    struct bus_stats *stats = zbus_chan_user_data(chan);
+
+    if (zbus_chan_claim(chan, K_MSEC(BUS_CLAIM_TIMEOUT_MS)) < 0) {
+        atomic_inc(&stats->claim_failures);
+        return NULL;
+    }
+    return zbus_chan_msg(chan);
+}
+
+int bus_publish_claimed(const struct zbus_channel *chan)
+{
+    struct bus_stats *stats = zbus_chan_user_data(chan);
+
+    stats->publishes++;
+    stats->published_at = k_cycle_get_32();
+    zbus_chan_finish(chan);
+
+    return zbus_chan_notify(chan, K_MSEC(BUS_CLAIM_TIMEOUT_MS));
+}
+
+int bus_publish(const struct zbus_channel *chan, const void *msg)
+{
+    void *dst = bus_claim(chan);
+
+    if (dst == NULL) {
+        return -EBUSY;
+    }
+    memcpy(dst, msg, zbus_chan_msg_size(chan));
+
+    return bus_publish_claimed(chan);
+}
+
+void bus_observed(const struct zbus_channel *chan)
+{
+    struct bus_stats *stats = zbus_chan_user_data(chan);
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - stats->published_at);
+
+    stats->notifies++;
+    stats->obs_sum_us += us;
+    stats->obs_max_us = MAX(stats->obs_max_us, us);
+}
+
+static bool bus_print_chan(const struct zbus_channel *chan)
+{
+    struct bus_stats *stats = zbus_chan_user_data(chan);
+    struct bus_stats s;
+
+    if (zbus_chan_claim(chan, K_MSEC(BUS_CLAIM_TIMEOUT_MS)) < 0) {
+        uart_io_printf("%-10s (busy)\n", zbus_chan_name(chan));
+        return true;
+    }
+    s = *stats;
+    zbus_chan_finish(chan);
+
+    uart_io_printf("%-10s %8u %8u %6u %8u %8u\n", zbus_chan_name(chan), s.publishes, s.notifies,
+                   (uint32_t)atomic_get(&stats->claim_failures),
+                   s.notifies ? (uint32_t)(s.obs_sum_us / s.notifies) : 0, s.obs_max_us);
+    return true;
+}
+
+// Comando "bus": publicações, notificações e latência dos observadores por canal:
+static int cmd_bus(int argc, char *argv[])
+{
+    uart_io_printf("\n=== DATA BUS ===\n");
+    uart_io_printf("%-10s %8s %8s %6s %8s %8s\n", "Channel", "Pub", "Notify", "Lost",
+                   "Avg(us)", "Max(us)");
+    zbus_iterate_over_channels(bus_print_chan);
+    uart_io_printf("================\n\n");
+
+    return 0;
+}
+
+APP_CMD_DEFINE(bus, "bus", cmd_bus, NULL, 0, 0, "Show publish/notify counters per bus channel");
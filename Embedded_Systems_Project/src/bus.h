@@ -0,0 +1,56 @@
+#ifndef BUS_H
+#define BUS_H
+
+#include "config.h"
+#include "adc_snapshot.h"
+#include "cmd.h"
+#include <zephyr/zbus/zbus.h>
+
+// Canais de publicação/assinatura (zbus) entre as threads. Cada consumidor se
+// registra no próprio arquivo com ZBUS_CHAN_ADD_OBS, sem alterar o publicador.
+//
+// Os listeners rodam na thread que publica, com o canal travado, e leem a
+// mensagem no lugar com zbus_chan_const_msg (sem cópia). Devem ser curtos: no
+// adc_chan eles fazem parte do caminho da aquisição. Trabalho pesado vai para
+// um subscriber (thread própria), que só recebe a notificação.
+
+// Estado do LED (publicado por led_control e pelo comando "dim"):
+enum led_mode {
+    LED_MODE_OFF,
+    LED_MODE_ON,
+    LED_MODE_BLINK,
+    LED_MODE_DIM,
+};
+
+struct led_state_msg {
+    enum led_mode mode;
+    uint8_t dim_percent;   // Brilho em LED_MODE_DIM
+    uint32_t interval_ms;  // Meio período em LED_MODE_BLINK
+};
+
+// Comando executado pela UART (publicado por cmd_dispatch):
+struct cmd_event_msg {
+    const struct app_cmd *cmd; // Entrada da tabela de comandos (fica na flash)
+    int32_t result;            // Retorno do handler
+    uint32_t timestamp;        // k_uptime_get_32 no fim da execução
+};
+
+ZBUS_CHAN_DECLARE(adc_chan,  // struct adc_snapshot: um valor por bloco do ADC
+                  led_chan,  // struct led_state_msg
+                  cmd_chan); // struct cmd_event_msg
+
+// Reserva a mensagem do canal para ser preenchida no lugar (NULL se o canal
+// ficar ocupado por mais de BUS_CLAIM_TIMEOUT_MS; a falha é contabilizada):
+void *bus_claim(const struct zbus_channel *chan);
+
+// Libera a mensagem reservada e notifica os observadores:
+int bus_publish_claimed(const struct zbus_channel *chan);
+
+// Copia msg para o canal e notifica (para mensagens pequenas):
+int bus_publish(const struct zbus_channel *chan, const void *msg);
+
+// Chamada no início de cada listener: conta a notificação e registra a latência
+// desde a publicação. Só pode ser usada com o canal travado (dentro do listener).
+void bus_observed(const struct zbus_channel *chan);
+
+#endif /* BUS_H */
@@ -0,0 +1,320 @@
+#include "calib.h"
+#include "adc_acq.h"
+#include "adc_snapshot.h"
+#include "uart_io.h"
+#include "cmd.h"
+#include <stdlib.h>
+#include <zephyr/settings/settings.h>
+
+#define CALIB_ONE (1 << CALIB_FRAC_BITS)
+
+BUILD_ASSERT((CALIB_LUT_SIZE - 1) * CALIB_ONE <= UINT16_MAX,
+             "calibration points keep raw codes in 16 bits");
+
+// Ponto medido por "cal point": código médio do primeiro canal (em 1/16 de
+// código) com uma tensão conhecida na entrada. É o formato salvo na flash.
+struct calib_point {
+    uint16_t raw_q4;
+    uint16_t mv;
+};
+
+static struct calib_point calib_points[CALIB_MAX_POINTS]; // Em ordem crescente de raw_q4
+static uint8_t calib_count;
+static bool calib_storage;                    // Settings disponível (pontos persistem)
+
+static uint16_t calib_lut[CALIB_LUT_SIZE];    // Código bruto -> mV em 1/16 mV
+static int32_t calib_full_scale_mv;
+static uint32_t calib_pct_scale;              // 100 / fundo de escala, em Q16
+
+static int calib_settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+    const char *next;
+    ssize_t ret;
+
+    if (!settings_name_steq(name, "points", &next) || next != NULL) {
+        return -ENOENT;
+    }
+    if (len > sizeof(calib_points) || len % sizeof(struct calib_point) != 0) {
+        return -EINVAL;
+    }
+
+    ret = read_cb(cb_arg, calib_points, len);
+    if (ret < 0) {
+        return ret;
+    }
+    calib_count = len / sizeof(struct calib_point);
+
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(calib, "cal", NULL, calib_settings_set, NULL, NULL);
+
+// Curva nominal do devicetree, de 1/16 de código para 1/16 mV:
+static int32_t calib_nominal_q4(int32_t raw_q4)
+{
+    const struct adc_dt_spec *spec = adc_acq_channel(0);
+
+    adc_raw_to_millivolts(spec->vref_mv, spec->channel_cfg.gain, ADC_RESOLUTION, &raw_q4);
+    return raw_q4;
+}
+
+// Pontos lidos da flash precisam estar em ordem e separados (a interpolação divide pela distância):
+static bool calib_points_valid(void)
+{
+    for (int i = 1; i < calib_count; i++) {
+        if (calib_points[i].raw_q4 < calib_points[i - 1].raw_q4 + CALIB_MIN_GAP_CODES * CALIB_ONE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void calib_build(void)
+{
+    int32_t offset = 0;
+    int seg = 0;
+
+    if (calib_count == 1) {
+        offset = calib_points[0].mv * CALIB_ONE - calib_nominal_q4(calib_points[0].raw_q4);
+    }
+
+    // A adc_thread não roda durante a troca, então nenhum bloco mistura duas curvas:
+    k_sched_lock();
+    for (int32_t code = 0; code < CALIB_LUT_SIZE; code++) {
+        int32_t raw_q4 = code * CALIB_ONE;
+        int32_t mv_q4;
+
+        if (calib_count < 2) {
+            mv_q4 = calib_nominal_q4(raw_q4) + offset;
+        } else {
+            const struct calib_point *p;
+
+            // Segmento que contém o código (o primeiro e o último valem também fora dos pontos):
+            while (seg < calib_count - 2 && raw_q4 >= calib_points[seg + 1].raw_q4) {
+                seg++;
+            }
+            p = &calib_points[seg];
+            mv_q4 = p[0].mv * CALIB_ONE +
+                    (int32_t)((int64_t)(raw_q4 - p[0].raw_q4) * ((p[1].mv - p[0].mv) * CALIB_ONE) /
+                              (p[1].raw_q4 - p[0].raw_q4));
+        }
+        calib_lut[code] = CLAMP(mv_q4, 0, UINT16_MAX);
+    }
+    k_sched_unlock();
+}
+
+int calib_init(void)
+{
+    int32_t full_q4 = CALIB_LUT_SIZE * CALIB_ONE;
+    int ret;
+
+    // Fundo de escala da porcentagem: tensão do maior código pela curva nominal
+    ret = adc_raw_to_millivolts(adc_acq_channel(0)->vref_mv, adc_acq_channel(0)->channel_cfg.gain,
+                                ADC_RESOLUTION, &full_q4);
+    if (ret < 0) {
+        return ret;
+    }
+    calib_full_scale_mv = full_q4 / CALIB_ONE;
+    calib_pct_scale = ((100U << 16) + calib_full_scale_mv / 2) / calib_full_scale_mv;
+
+    // Sem a partição storage_partition a calibração funciona, mas não persiste:
+    ret = settings_subsys_init();
+    if (ret == 0) {
+        ret = settings_load_subtree("cal");
+    }
+    calib_storage = ret == 0;
+
+    if (!calib_points_valid()) {
+        printk("Discarding invalid calibration points\n");
+        calib_count = 0;
+    }
+    calib_build();
+
+    return ret;
+}
+
+int32_t calib_block_mv(const int16_t *samples, uint16_t count)
+{
+    int32_t sum = 0;
+
+    // Uma leitura da tabela por amostra (os filtros podem passar um pouco da faixa do ADC):
+    for (int i = 0; i < count; i++) {
+        sum += calib_lut[CLAMP(samples[i], 0, CALIB_LUT_SIZE - 1)];
+    }
+
+    // Média arredondada para mV (uma divisão por bloco):
+    return (sum + count * (CALIB_ONE / 2)) / (count * CALIB_ONE);
+}
+
+int32_t calib_sample_mv(int16_t code)
+{
+    return (calib_lut[CLAMP(code, 0, CALIB_LUT_SIZE - 1)] + CALIB_ONE / 2) / CALIB_ONE;
+}
+
+int32_t calib_full_scale(void)
+{
+    return calib_full_scale_mv;
+}
+
+uint8_t calib_percent(int32_t voltage_mv)
+{
+    return ((uint32_t)CLAMP(voltage_mv, 0, calib_full_scale_mv) * calib_pct_scale) >> 16;
+}
+
+// Código médio do primeiro canal em CALIB_AVG_BLOCKS blocos novos do ADC:
+static int calib_measure(uint16_t *raw_q4)
+{
+    struct adc_snapshot snap;
+    // O dobro do tempo dos blocos na taxa atual, com folga para taxas altas:
+    int64_t deadline = k_uptime_get() + ADC_BLOCK_TIMEOUT_MS +
+                       2 * CALIB_AVG_BLOCKS * ADC_BLOCK_SAMPLES * MSEC_PER_SEC / adc_acq_rate_get();
+    uint32_t last_seq;
+    uint32_t sum = 0;
+    int blocks = 0;
+
+    adc_snapshot_get(&snap);
+    last_seq = snap.seq;
+
+    while (blocks < CALIB_AVG_BLOCKS) {
+        if (k_uptime_get() > deadline) {
+            return -ETIMEDOUT;
+        }
+        k_msleep(10);
+
+        adc_snapshot_get(&snap);
+        if (!snap.ready || snap.seq == last_seq) {
+            continue;
+        }
+        last_seq = snap.seq;
+        sum += snap.channels[0].raw_q4;
+        blocks++;
+    }
+
+    *raw_q4 = sum / CALIB_AVG_BLOCKS;
+    return 0;
+}
+
+static int calib_add_point(uint16_t raw_q4, uint16_t mv)
+{
+    int closest = -1;
+    int i;
+
+    // Medir de novo perto de um ponto existente o substitui (o mais próximo,
+    // para a ordem e a distância mínima aos vizinhos se manterem):
+    for (i = 0; i < calib_count; i++) {
+        int gap = abs(raw_q4 - calib_points[i].raw_q4);
+
+        if (gap < CALIB_MIN_GAP_CODES * CALIB_ONE &&
+            (closest < 0 || gap < abs(raw_q4 - calib_points[closest].raw_q4))) {
+            closest = i;
+        }
+    }
+    if (closest >= 0) {
+        // O ponto novo não pode ficar perto demais do outro vizinho, senão a
+        // lista salva seria recusada por calib_points_valid no próximo boot:
+        if ((closest > 0 &&
+             raw_q4 < calib_points[closest - 1].raw_q4 + CALIB_MIN_GAP_CODES * CALIB_ONE) ||
+            (closest < calib_count - 1 &&
+             raw_q4 + CALIB_MIN_GAP_CODES * CALIB_ONE > calib_points[closest + 1].raw_q4)) {
+            return -EINVAL;
+        }
+        calib_points[closest] = (struct calib_point){ .raw_q4 = raw_q4, .mv = mv };
+        return 0;
+    }
+
+    if (calib_count == CALIB_MAX_POINTS) {
+        return -ENOSPC;
+    }
+
+    // Inserção mantendo a ordem de raw_q4:
+    for (i = calib_count; i > 0 && calib_points[i - 1].raw_q4 > raw_q4; i--) {
+        calib_points[i] = calib_points[i - 1];
+    }
+    calib_points[i] = (struct calib_point){ .raw_q4 = raw_q4, .mv = mv };
+    calib_count++;
+
+    return 0;
+}
+
+static int calib_save(void)
+{
+    if (!calib_storage) {
+        return -ENODEV;
+    }
+    if (calib_count == 0) {
+        return settings_delete("cal/points");
+    }
+    return settings_save_one("cal/points", calib_points, calib_count * sizeof(struct calib_point));
+}
+
+static void calib_print(void)
+{
+    static const char *const curve[] = { "nominal (devicetree)", "nominal + offset" };
+
+    uart_io_printf("\n=== ADC CALIBRATION ===\n");
+    uart_io_printf("Curve: %s, %u point(s)%s\n", calib_count < 2 ? curve[calib_count] : "piecewise linear",
+                   calib_count, calib_storage ? "" : " (not persistent)");
+    for (int i = 0; i < calib_count; i++) {
+        uart_io_printf("  raw %4u.%u -> %4u mV\n", calib_points[i].raw_q4 / CALIB_ONE,
+                       (calib_points[i].raw_q4 % CALIB_ONE) * 10 / CALIB_ONE, calib_points[i].mv);
+    }
+    uart_io_printf("Table: code 0 = %u mV, %u = %u mV, %u = %u mV\n", calib_lut[0] / CALIB_ONE,
+                   CALIB_LUT_SIZE / 2, calib_lut[CALIB_LUT_SIZE / 2] / CALIB_ONE, CALIB_LUT_SIZE - 1,
+                   calib_lut[CALIB_LUT_SIZE - 1] / CALIB_ONE);
+    uart_io_printf("Full scale (100%%): %d mV\n", calib_full_scale_mv);
+    uart_io_printf("=======================\n\n");
+}
+
+// Comando "cal [point <mV>|clear]": com uma tensão conhecida no primeiro canal,
+// "cal point <mV>" mede o código médio e acrescenta o ponto; "cal clear" volta à
+// curva nominal. A tabela é remontada e os pontos salvos a cada mudança.
+static int cmd_cal(int argc, char *argv[])
+{
+    uint32_t mv;
+    uint16_t raw_q4;
+    int ret;
+
+    if (argc == 1) {
+        calib_print();
+        return 0;
+    }
+
+    if (strcmp(argv[1], "point") == 0) {
+        if (argc != 3 || cmd_parse_u32(argv[2], 0, UINT16_MAX / CALIB_ONE, &mv) < 0) {
+            return -EINVAL;
+        }
+
+        uart_io_printf("Measuring %u ADC blocks...\n", CALIB_AVG_BLOCKS);
+        ret = calib_measure(&raw_q4);
+        if (ret < 0) {
+            return ret;
+        }
+
+        ret = calib_add_point(raw_q4, mv);
+        if (ret == -ENOSPC) {
+            uart_io_printf("Calibration full (%u points), use 'cal clear'\n", CALIB_MAX_POINTS);
+            return 0;
+        }
+        if (ret == -EINVAL) {
+            uart_io_printf("Point at raw %u is closer than %u codes to two saved points, not added\n",
+                           raw_q4 / CALIB_ONE, CALIB_MIN_GAP_CODES);
+            return 0;
+        }
+    } else if (strcmp(argv[1], "clear") == 0 && argc == 2) {
+        calib_count = 0;
+    } else {
+        return -EINVAL;
+    }
+
+    calib_build();
+    ret = calib_save();
+    if (ret < 0) {
+        uart_io_printf("Calibration not saved (%d)\n", ret);
+    }
+    calib_print();
+
+    return 0;
+}
+
+APP_CMD_DEFINE(cal, "cal", cmd_cal, "[point <mV>|clear]", 0, 2,
+               "Show or calibrate the ADC raw-to-mV table");
@@ -0,0 +1,30 @@
+#ifndef CALIB_H
+#define CALIB_H
+
+#include "config.h"
+
+// Calibração do ADC: uma tabela de CALIB_LUT_SIZE entradas leva cada código
+// bruto direto a mV (em 1/16 mV), e a porcentagem sai de uma multiplicação e
+// um deslocamento. A tabela é montada pelos pontos medidos com o comando "cal"
+// e salvos na flash (settings, chave "cal/points"):
+//   sem pontos   curva nominal do devicetree (vref e ganho do primeiro canal)
+//   um ponto     curva nominal com correção de offset
+//   dois ou mais interpolação linear entre os pontos, estendida nas pontas
+// A tabela é única: todos os canais devem usar o mesmo ganho e referência.
+
+// Carrega os pontos salvos e monta a tabela (sem pontos válidos, usa a curva nominal):
+int calib_init(void);
+
+// Média de count amostras de um canal em mV, pela tabela:
+int32_t calib_block_mv(const int16_t *samples, uint16_t count);
+
+// Uma amostra em mV pela tabela (usada pelos alarmes, no callback do ADC):
+int32_t calib_sample_mv(int16_t code);
+
+// Fundo de escala (100%) em mV, pela curva nominal do devicetree (também o topo do gráfico):
+int32_t calib_full_scale(void);
+
+// Porcentagem de uma tensão em relação ao fundo de escala (vref), limitada a 0..100:
+uint8_t calib_percent(int32_t voltage_mv);
+
+#endif /* CALIB_H */
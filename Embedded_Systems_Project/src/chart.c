@@ -0,0 +1,179 @@
+#include "chart.h"
+#include "text_display.h"
+#include "display_sched.h"
+#include "uart_io.h"
+#include "cmd.h"
+#include "bus.h"
+#include "adc_acq.h"
+#include "calib.h"
+
+#define CHART_TRACE_COLOR 0xFFE0 // Amarelo
+#define CHART_GRID_COLOR  0x2104 // Cinza escuro (linhas de 25%, 50% e 75%)
+
+// Colunas por buffer de trecho (cada coluna tem CHART_HEIGHT pixels):
+#define CHART_COLUMNS_PER_STRIP (TEXT_STRIP_PIXELS / CHART_HEIGHT)
+
+BUILD_ASSERT(CHART_COLUMNS_PER_STRIP >= 1, "a chart column must fit in one display strip");
+BUILD_ASSERT((CHART_HISTORY & (CHART_HISTORY - 1)) == 0 && CHART_HISTORY > CHART_WIDTH,
+             "CHART_HISTORY must be a power of two larger than CHART_WIDTH");
+
+// Histórico em mV, indexado pelo número do valor (n & (CHART_HISTORY - 1)). A
+// folga sobre CHART_WIDTH deixa o quadro em andamento ler os valores antigos
+// sem trava enquanto a adc_thread grava os novos.
+static int16_t chart_values[CHART_HISTORY];
+static uint32_t chart_head;     // Valores gravados desde o início (ou o último "chart <n>")
+static int32_t chart_acc_mv;    // Soma dos blocos da coluna em andamento
+static uint32_t chart_acc_count;
+static uint32_t chart_blocks = CHART_BLOCKS_PER_COLUMN;
+static struct k_spinlock chart_lock;
+
+// Estado do desenho (só a display_thread acessa):
+static uint32_t chart_drawn;    // chart_head no último quadro
+static bool chart_redraw = true; // Quadro inteiro no próximo flush (pedido sob chart_lock)
+
+// Listener do adc_chan (na adc_thread): acumula o valor e fecha uma coluna a
+// cada chart_blocks blocos.
+static void chart_adc_cb(const struct zbus_channel *chan)
+{
+    const struct adc_snapshot *snap = zbus_chan_const_msg(chan);
+    bool column = false;
+    k_spinlock_key_t key;
+
+    bus_observed(chan);
+
+    key = k_spin_lock(&chart_lock);
+    chart_acc_mv += snap->voltage_mv;
+    if (++chart_acc_count >= chart_blocks) {
+        chart_values[chart_head & (CHART_HISTORY - 1)] = chart_acc_mv / (int32_t)chart_acc_count;
+        chart_head++;
+        chart_acc_mv = 0;
+        chart_acc_count = 0;
+        column = true;
+    }
+    k_spin_unlock(&chart_lock, key);
+
+    if (column) {
+        display_sched_request();
+    }
+}
+
+ZBUS_LISTENER_DEFINE(chart_adc_lis, chart_adc_cb);
+ZBUS_CHAN_ADD_OBS(adc_chan, chart_adc_lis, 3);
+
+// Topo do gráfico no mesmo fundo de escala da porcentagem do texto:
+static inline int chart_row(int32_t mv, int32_t full_scale_mv)
+{
+    mv = CLAMP(mv, 0, full_scale_mv);
+    return (CHART_HEIGHT - 1) - mv * (CHART_HEIGHT - 1) / full_scale_mv;
+}
+
+// Renderiza as colunas [x0, x0 + w) para o valor mais recente head - 1. A coluna
+// head % CHART_WIDTH é o cursor (vazia); as demais mostram o valor mais recente
+// que cai nelas, ligado ao anterior por um segmento vertical.
+static void chart_render(uint16_t *pixels, int x0, int w, uint32_t head)
+{
+    int32_t full_scale_mv = MAX(calib_full_scale(), 1); // 0 se calib_init falhou cedo
+
+    for (int c = 0; c < w; c++) {
+        uint32_t offset = (x0 + c + CHART_WIDTH - head % CHART_WIDTH) % CHART_WIDTH;
+        uint32_t n;
+        int y;
+        int y_prev;
+
+        for (int r = 0; r < CHART_HEIGHT; r++) {
+            bool grid = r == CHART_HEIGHT / 4 || r == CHART_HEIGHT / 2 || r == 3 * CHART_HEIGHT / 4;
+            pixels[r * w + c] = grid ? CHART_GRID_COLOR : 0;
+        }
+
+        if (offset == 0 || head < CHART_WIDTH - offset) {
+            continue; // Cursor, ou coluna ainda sem valor
+        }
+
+        n = head - CHART_WIDTH + offset;
+        y = chart_row(chart_values[n & (CHART_HISTORY - 1)], full_scale_mv);
+        y_prev = n > 0 ? chart_row(chart_values[(n - 1) & (CHART_HISTORY - 1)], full_scale_mv) : y;
+
+        for (int r = MIN(y, y_prev); r <= MAX(y, y_prev); r++) {
+            pixels[r * w + c] = CHART_TRACE_COLOR;
+        }
+    }
+}
+
+void chart_flush(void)
+{
+    k_spinlock_key_t key;
+    uint32_t head;
+    uint32_t first;
+    uint32_t count;
+    bool redraw;
+
+    if (!display_dev || !device_is_ready(display_dev)) {
+        return;
+    }
+
+    key = k_spin_lock(&chart_lock);
+    head = chart_head;
+    redraw = chart_redraw;
+    chart_redraw = false;
+    k_spin_unlock(&chart_lock, key);
+
+    // "chart <n>" pede o quadro inteiro: head volta a zero e pode já ter passado
+    // de chart_drawn, o que deixaria colunas com a escala antiga na tela
+    if (redraw || head - chart_drawn >= CHART_WIDTH) {
+        first = 0;
+        count = CHART_WIDTH;
+    } else if (head == chart_drawn) {
+        return;
+    } else {
+        // Colunas dos valores novos (a primeira é o cursor anterior) mais o novo cursor:
+        first = chart_drawn % CHART_WIDTH;
+        count = head - chart_drawn + 1;
+    }
+    chart_drawn = head;
+
+    while (count > 0) {
+        uint32_t w = MIN(MIN(count, CHART_WIDTH - first), CHART_COLUMNS_PER_STRIP);
+        uint16_t *pixels = display_strip_alloc();
+
+        chart_render(pixels, first, w, head);
+        display_strip_submit(pixels, CHART_X + first, CHART_Y, w, CHART_HEIGHT);
+
+        first = (first + w) % CHART_WIDTH;
+        count -= w;
+    }
+}
+
+// Comando "chart [blocks]": mostra ou altera quantos valores do ADC formam uma coluna
+static int cmd_chart(int argc, char *argv[])
+{
+    k_spinlock_key_t key;
+    uint32_t blocks;
+    uint32_t span_ms;
+
+    if (argc == 2) {
+        if (cmd_parse_u32(argv[1], 1, 64, &blocks) < 0) {
+            return -EINVAL;
+        }
+
+        // Muda a escala de tempo: o histórico antigo é descartado
+        key = k_spin_lock(&chart_lock);
+        chart_blocks = blocks;
+        chart_head = 0;
+        chart_acc_mv = 0;
+        chart_acc_count = 0;
+        chart_redraw = true;
+        k_spin_unlock(&chart_lock, key);
+        display_sched_request();
+    }
+
+    // Na taxa atual (com "rate auto" o histórico pode misturar taxas):
+    span_ms = (uint32_t)((uint64_t)CHART_WIDTH * chart_blocks * ADC_BLOCK_SAMPLES * 1000 /
+                         adc_acq_rate_get());
+    uart_io_printf("Chart: %u columns x %u block(s), %u.%01u s of history, %u values so far\n",
+                   CHART_WIDTH, chart_blocks, span_ms / 1000, (span_ms % 1000) / 100, chart_head);
+
+    return 0;
+}
+
+APP_CMD_DEFINE(chart, "chart", cmd_chart, "[1-64]", 0, 1,
+               "Show or set ADC blocks averaged per chart column");
@@ -0,0 +1,15 @@
+#ifndef CHART_H
+#define CHART_H
+
+#include "config.h"
+
+// Gráfico de histórico do primeiro canal do ADC, abaixo da área de texto. Em
+// modo varredura: cada valor novo ocupa a coluna do mais antigo, seguida de uma
+// coluna vazia que marca a posição atual. O custo por valor é uma coluna,
+// independente do tamanho do histórico.
+
+// display_thread: enfileira as colunas dos valores novos desde o último quadro
+// (o primeiro quadro desenha o gráfico inteiro):
+void chart_flush(void);
+
+#endif /* CHART_H */
@@ -0,0 +1,145 @@
+#include "cmd.h"
+#include "uart_io.h"
+#include "bus.h"
+#include <stdlib.h>
+
+// Tabela hash com endereçamento aberto, montada uma vez a partir da seção de
+// comandos. A busca custa um hash da palavra e, em geral, uma única comparação.
+static const struct app_cmd *cmd_table[CMD_HASH_SIZE];
+static uint32_t cmd_hashes[CMD_HASH_SIZE];
+
+// Hash FNV-1a de 32 bits:
+static uint32_t cmd_hash(const char *s)
+{
+    uint32_t h = 2166136261u;
+
+    while (*s) {
+        h ^= (uint8_t)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+int cmd_init(void)
+{
+    size_t count;
+
+    STRUCT_SECTION_COUNT(app_cmd, &count);
+    if (count > CMD_HASH_SIZE / 2) {
+        printk("Too many commands (%u) for CMD_HASH_SIZE\n", (unsigned int)count);
+        return -ENOMEM;
+    }
+
+    STRUCT_SECTION_FOREACH(app_cmd, cmd) {
+        uint32_t h = cmd_hash(cmd->name);
+        uint32_t slot = h & (CMD_HASH_SIZE - 1);
+
+        while (cmd_table[slot] != NULL) {
+            slot = (slot + 1) & (CMD_HASH_SIZE - 1);
+        }
+        cmd_table[slot] = cmd;
+        cmd_hashes[slot] = h;
+    }
+
+    return 0;
+}
+
+const struct app_cmd *cmd_find(const char *name)
+{
+    uint32_t h = cmd_hash(name);
+    uint32_t slot = h & (CMD_HASH_SIZE - 1);
+
+    while (cmd_table[slot] != NULL) {
+        if (cmd_hashes[slot] == h && strcmp(cmd_table[slot]->name, name) == 0) {
+            return cmd_table[slot];
+        }
+        slot = (slot + 1) & (CMD_HASH_SIZE - 1);
+    }
+    return NULL;
+}
+
+int cmd_dispatch(char *line)
+{
+    char *argv[CMD_MAX_ARGS + 1];
+    int argc = 0;
+    char *save;
+    char *tok;
+    const struct app_cmd *cmd;
+    int ret;
+
+    for (tok = strtok_r(line, " \t", &save); tok != NULL; tok = strtok_r(NULL, " \t", &save)) {
+        if (argc == CMD_MAX_ARGS + 1) {
+            uart_io_printf("Too many arguments\n");
+            return -E2BIG;
+        }
+        argv[argc++] = tok;
+    }
+
+    if (argc == 0) {
+        return 0;
+    }
+
+    cmd = cmd_find(argv[0]);
+    if (cmd == NULL) {
+        uart_io_printf("Unknown command: %s\n", argv[0]);
+        uart_io_printf("Type 'help' for available commands.\n");
+        return -ENOENT;
+    }
+
+    if (argc - 1 < cmd->min_args || argc - 1 > cmd->max_args) {
+        ret = -EINVAL;
+    } else {
+        ret = cmd->handler(argc, argv);
+    }
+
+    // Publica o comando executado no cmd_chan (observado pelo agendador do display):
+    bus_publish(&cmd_chan, &(struct cmd_event_msg){
+        .cmd = cmd,
+        .result = ret,
+        .timestamp = k_uptime_get_32(),
+    });
+
+    if (ret == -EINVAL) {
+        uart_io_printf("Usage: %s %s\n", cmd->name, cmd->args ? cmd->args : "");
+    } else if (ret < 0) {
+        uart_io_printf("Command '%s' failed: %d\n", cmd->name, ret);
+    }
+
+    return ret;
+}
+
+int cmd_parse_u32(const char *arg, uint32_t min, uint32_t max, uint32_t *value)
+{
+    char *end;
+    unsigned long v = strtoul(arg, &end, 10);
+
+    if (end == arg || *end != '\0' || v < min || v > max) {
+        return -EINVAL;
+    }
+
+    *value = v;
+    return 0;
+}
+
+// Lista de comandos gerada a partir do registro. Nome e sintaxe saem inteiros,
+// alinhados pela entrada mais longa (cada parte em uma chamada, dentro de UART_IO_LINE_MAX):
+static int cmd_help(int argc, char *argv[])
+{
+    int width = 0;
+
+    STRUCT_SECTION_FOREACH(app_cmd, cmd) {
+        width = MAX(width, (int)(strlen(cmd->name) + 1 + (cmd->args ? strlen(cmd->args) : 0)));
+    }
+
+    uart_io_printf("\n=== COMMANDS ===\n");
+    STRUCT_SECTION_FOREACH(app_cmd, cmd) {
+        uart_io_printf("  %s %-*s", cmd->name, width - (int)strlen(cmd->name) - 1,
+                       cmd->args ? cmd->args : "");
+        uart_io_printf(" - %s\n", cmd->help);
+    }
+    uart_io_printf("================\n\n");
+
+    return 0;
+}
+
+APP_CMD_DEFINE(help, "help", cmd_help, NULL, 0, 0, "Show this help menu");
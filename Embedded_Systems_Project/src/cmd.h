@@ -0,0 +1,41 @@
+#ifndef CMD_H
+#define CMD_H
+
+#include "config.h"
+#include <zephyr/sys/iterable_sections.h>
+
+// Comando da UART registrado em tempo de link (seção iterável "app_cmd"):
+struct app_cmd {
+    const char *name;
+    int (*handler)(int argc, char *argv[]); // argv[0] é o nome do comando
+    const char *args;                        // Sintaxe dos argumentos, para o help
+    const char *help;
+    uint8_t min_args;                        // Quantidade de argumentos aceita (sem o nome)
+    uint8_t max_args;
+};
+
+// Registra um comando. O handler retorna 0 ou um código de erro negativo;
+// -EINVAL faz o dispatcher imprimir a sintaxe do comando.
+#define APP_CMD_DEFINE(_id, _name, _handler, _args, _min, _max, _help) \
+    STRUCT_SECTION_ITERABLE(app_cmd, app_cmd_##_id) = {                 \
+        .name = _name,                                                  \
+        .handler = _handler,                                            \
+        .args = _args,                                                  \
+        .help = _help,                                                  \
+        .min_args = _min,                                               \
+        .max_args = _max,                                               \
+    }
+
+// Monta a tabela hash com todos os comandos registrados:
+int cmd_init(void);
+
+// Busca um comando pelo nome (NULL se não existir):
+const struct app_cmd *cmd_find(const char *name);
+
+// Separa a linha em argumentos (altera a linha) e executa o comando correspondente:
+int cmd_dispatch(char *line);
+
+// Converte um argumento numérico, validando a faixa [min, max]:
+int cmd_parse_u32(const char *arg, uint32_t min, uint32_t max, uint32_t *value);
+
+#endif /* CMD_H */
@@ -9,35 +9,120 @@
 #include <zephyr/drivers/uart.h>
 #include <zephyr/drivers/display.h>
 #include <zephyr/drivers/adc.h>
-#include <zephyr/sys/sys_heap.h>
+#include <zephyr/sys/ring_buffer.h>
 
 #define UART_DEVICE_NODE    DT_CHOSEN(zephyr_console) // Nó escolhido para comunicação serial na Device Tree
 #define LED0_NODE           DT_ALIAS(led0) // Define nó do LED q será utilizado pelo código
 
-#define LED_BLINK_INTERVAL_MS   500  // Tempo entre cada piscada do LED
+#define LED_BLINK_INTERVAL_MS   500  // Tempo inicial entre cada piscada do LED (comando "blink")
+#define LED_BLINK_MIN_MS        10
+#define LED_BLINK_MAX_MS        10000
 
-// Definição do ADC na Device Tree:
-#define ADC_NODE DT_NODELABEL(adc1)
-#define ADC_RESOLUTION 12
-#define ADC_GAIN ADC_GAIN_1
-#define ADC_REFERENCE ADC_REF_INTERNAL
-#define ADC_ACQUISITION_TIME ADC_ACQ_TIME_DEFAULT
-#define ADC_CHANNEL_ID 1
+#define SERVO_MAX_ANGLE       180  // Ângulo correspondente a max-pulse
+#define SERVO_SLEW_DEG_PER_S  90   // Velocidade máxima do servo no modo seguidor do ADC
+
+#define UART_RX_RING_SIZE 64   // Bytes recebidos pela UART aguardando a uart_thread
+#define UART_TX_RING_SIZE 2048 // Bytes de relatórios aguardando a interrupção de TX
+#define UART_IO_LINE_MAX  128  // Tamanho máximo de uma chamada de uart_io_printf
+
+#define TELEMETRY_FRAME_POOL 4 // Quadros de telemetria em trânsito entre a adc_thread e a UART
+
+#define LATENCY_BUCKETS 22 // Baldes de potência de 2 (até ~2 s) dos histogramas de latência
+
+// Comandos da UART:
+#define CMD_LINE_MAX  256 // Tamanho máximo de uma linha ("filter fir" com 31 coeficientes de até 6 caracteres)
+#define CMD_MAX_ARGS  32  // Argumentos por comando (sem contar o nome): "fir" e até FILTER_MAX_TAPS coeficientes
+#define CMD_HASH_SIZE 64  // Entradas da tabela hash (potência de 2, ao menos o dobro dos comandos)
+
+#define BUS_CLAIM_TIMEOUT_MS 10 // Espera máxima por um canal do zbus ocupado
+
+// Alarmes de limite (comando "alarm"), avaliados no callback do ADC:
+#define ALARM_HYST_MV     20   // Histerese padrão
+#define ALARM_DEBOUNCE    3    // Amostras seguidas padrão para mudar de estado
+#define ALARM_MAX_MV      4095 // Maior limite aceito (faixa da tabela de calibração)
+#define ALARM_EVENT_QUEUE 8    // Mudanças aguardando a thread de alarmes
+#define ALARM_PRIORITY    2    // Acima da adc_thread: o LED reage antes do processamento do bloco
+#define ALARM_CHECK_DELAY_MS 1000 // Tempo para o alarme de teste disparar no boot (CI)
+
+#define DATALOG_RECORD_SIZE  1024 // Lote em RAM gravado como um registro do log na flash
+#define DATALOG_BATCH_POOL   3    // Lotes: um em montagem e até dois aguardando a gravação
+#define DATALOG_MAX_SECTORS  8    // Setores da partição log_partition
+#define DATALOG_PRIORITY     10   // Thread de gravação, abaixo das demais
+#define DATALOG_FLUSH_TIMEOUT_MS 500 // Espera pelo lote em montagem ("log dump")
+#define DATALOG_CHECK_DELAY_MS   3000 // Tempo de aquisição antes da verificação no boot (CI)
+#define DATALOG_CHECK_TOL_MV     5
+
+#define THREAD_STATS_WINDOW_MS   1000 // Janela de medição do uso de CPU (comando "top")
+#define THREAD_STATS_MAX_THREADS 12   // Threads acompanhadas (inclui main, idle e workqueue)
+#define STACK_CHECK_MAX_PCT      75   // Uso máximo de pilha aceito na verificação do boot (CI)
+#define STACK_CHECK_DELAY_MS     3000 // Tempo com todos os observadores ativos antes da verificação
+
+#define BENCH_ITERATIONS 1000 // Repetições padrão do comando "bench"
+#define BENCH_EMUL_INPUT_MV 1650 // Entrada fixa do ADC emulado (sem potenciômetro)
+
+// Canais do ADC: lista io-channels do nó zephyr,user no overlay da placa.
+// Todos ficam no mesmo controlador e são convertidos em uma única sequência.
+#define ADC_USER_NODE    DT_PATH(zephyr_user)
+#define ADC_NODE         DT_IO_CHANNELS_CTLR(ADC_USER_NODE)
+#define ADC_NUM_CHANNELS DT_PROP_LEN(ADC_USER_NODE, io_channels)
+#define ADC_MAX_CHANNELS 4    // Linhas reservadas no display (o primeiro canal é o potenciômetro)
+#define ADC_RESOLUTION   12   // Resolução esperada em zephyr,resolution de cada canal
+
+// Aquisição contínua do ADC:
+#define ADC_SAMPLE_RATE_HZ   1000  // Taxa de amostragem inicial (Hz, comando "rate")
+#define ADC_RATE_MIN_HZ      10
+#define ADC_RATE_MAX_HZ      10000 // Uma varredura por tick (CONFIG_SYS_CLOCK_TICKS_PER_SEC)
+#define ADC_DECIMATION_BITS  3     // Bits extras de resolução obtidos por sobreamostragem
+#define ADC_BLOCK_SAMPLES    (1 << (2 * ADC_DECIMATION_BITS)) // 4^N amostras por valor publicado (64)
+#define ADC_RING_BLOCKS      4     // Blocos no buffer circular da aquisição
+#define ADC_BLOCK_TIMEOUT_MS 100   // Tempo máximo de espera por um bloco antes de verificar erros
+// Taxa adaptativa ("rate auto"): sobe quando o valor muda rápido e desce quando estabiliza
+#define ADC_AUTO_MIN_HZ        100
+#define ADC_AUTO_MAX_HZ        4000
+#define ADC_AUTO_FAST_MV       50  // Variação entre blocos consecutivos que dobra a taxa
+#define ADC_AUTO_STABLE_MV     5   // Variação abaixo da qual o sinal é considerado estável
+#define ADC_AUTO_STABLE_BLOCKS 16  // Blocos estáveis seguidos para reduzir a taxa à metade
+#define FILTER_MAX_TAPS      31    // Maior janela/número de coeficientes do filtro (comando "filter")
+
+// Calibração (comando "cal"): tabela código bruto -> mV montada a partir dos pontos salvos
+#define CALIB_LUT_SIZE      (1 << ADC_RESOLUTION) // Uma entrada por código do ADC (4096)
+#define CALIB_FRAC_BITS     4     // Tabela em 1/16 mV: a média do bloco mantém os bits da decimação
+#define CALIB_MAX_POINTS    8     // Pontos de calibração (tensão conhecida x código medido)
+#define CALIB_MIN_GAP_CODES 16    // Pontos mais próximos que isso substituem o anterior
+#define CALIB_AVG_BLOCKS    8     // Blocos do ADC promediados ao medir um ponto
+
+#define DISPLAY_MAX_FPS       10   // Quadros por segundo no máximo (comando "display fps")
+#define DISPLAY_MAX_FPS_LIMIT 60
+#define DISPLAY_COALESCE_MS   20   // Janela que junta eventos próximos em um único quadro
+#define DISPLAY_DEADBAND_MV   5    // Variações de até N mV não redesenham a tela
+#define DISPLAY_DEADBAND_PCT  0    // Idem para a porcentagem (0 = qualquer mudança visível)
 
 #define TEXT_BUFFER_WIDTH  160   
-#define TEXT_BUFFER_HEIGHT  64   
-#define TEXT_BUFFER_SIZE    (TEXT_BUFFER_WIDTH * TEXT_BUFFER_HEIGHT)
+#define TEXT_BUFFER_HEIGHT  112  // Três linhas de status e uma por canal extra do ADC
+#define TEXT_SURFACE_STRIDE (TEXT_BUFFER_WIDTH / 8)  // Bytes por linha da superfície de 1 bpp
+#define TEXT_SURFACE_SIZE   (TEXT_SURFACE_STRIDE * TEXT_BUFFER_HEIGHT)
+#define TEXT_CHUNK_ROWS     8    // Linhas expandidas para RGB565 por escrita no display (um campo inteiro)
+#define TEXT_STRIP_COUNT    2    // Buffers de trecho: um em transmissão enquanto o outro é renderizado
+#define TEXT_STRIP_PIXELS   (TEXT_CHUNK_ROWS * TEXT_BUFFER_WIDTH)
+#define DISPLAY_TX_PRIORITY 7    // Thread que transmite os trechos (acima do display_thread)
+#define TEXT_ORIGIN_X       10   // Posição da área de texto na tela
+#define TEXT_ORIGIN_Y       10
 
-#define APP_HEAP_SIZE 16384  // Tamanho do heap em bytes
-static char app_heap_mem[APP_HEAP_SIZE];
-static struct sys_heap app_heap;
+#define CHART_X        10   // Gráfico de histórico do ADC, abaixo da área de texto
+#define CHART_Y        140
+#define CHART_WIDTH    220  // Colunas (uma por valor do histórico)
+#define CHART_HEIGHT   100  // Cabe em um buffer de trecho (TEXT_STRIP_PIXELS)
+#define CHART_HISTORY  256  // Valores guardados (potência de 2, com folga sobre CHART_WIDTH)
+#define CHART_BLOCKS_PER_COLUMN 1 // Valores do ADC promediados por coluna (comando "chart")
 
 extern const struct device *uart_dev; // Declara um ponteiro para o dispositivo UART a ser definido em outros arquivos (n vai precisar redefinir)
 extern const struct gpio_dt_spec led0; // Declara uma estrutura para configurar um pino GPIO em outro arquivo.
 extern const struct device *display_dev; // Declara um ponteiro pro display.
+extern struct k_mutex display_mutex; // Protege a superfície de texto (display_thread e comando "bench")
 
 // Protótipos de funções:
 void led_control(int command);
+void led_alarm(bool active);  // Thread de alarmes: LED piscando enquanto houver alarme
 void display_init(void);
 void display_update_status(const char *status);
 
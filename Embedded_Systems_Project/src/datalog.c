@@ -0,0 +1,503 @@
+#include "datalog.h"
+#include "adc_acq.h"
+#include "bus.h"
+#include "cmd.h"
+#include "pool.h"
+#include "telemetry.h"
+#include "uart_io.h"
+#include <zephyr/fs/fcb.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+
+#define DATALOG_PARTITION FIXED_PARTITION_ID(log_partition)
+#define DATALOG_MAGIC     0x41444c47 // Identifica os setores do log no FCB
+#define DATALOG_VALUE_MAX 5          // Maior varint de 32 bits
+
+// Lote em RAM: o registro é montado direto em data e gravado sem cópia.
+struct datalog_batch {
+    void *fifo_reserved;  // Uso interno da k_fifo
+    uint16_t len;
+    uint16_t count;       // Valores por canal
+    bool flush;           // datalog_flush espera pela gravação deste lote
+    uint8_t data[DATALOG_RECORD_SIZE + 8]; // Folga para completar o alinhamento da flash
+};
+
+struct datalog_stats {
+    uint32_t values;        // Valores (por canal) codificados
+    uint32_t dropped;       // Valores perdidos sem lote livre
+    uint32_t records;       // Registros gravados desde o boot
+    uint32_t payload_bytes; // Bytes dos registros
+    uint32_t flash_bytes;   // Bytes programados (com cabeçalho do FCB e alinhamento)
+    uint32_t erases;        // Setores apagados na rotação do log
+    uint32_t errors;        // Falhas de gravação (lote perdido)
+    uint64_t flash_us;      // Tempo total em operações de flash
+    uint32_t max_us;
+};
+
+APP_POOL_DEFINE(datalog_batches, "datalog", ROUND_UP(sizeof(struct datalog_batch), 4),
+                DATALOG_BATCH_POOL);
+
+// Quadros do "log dump": um registro inteiro por quadro de telemetria
+APP_POOL_DEFINE(datalog_dump_frames, "logdump",
+                ROUND_UP(sizeof(struct uart_buf) + TELEMETRY_FRAME_SIZE(5 + DATALOG_RECORD_SIZE), 4), 2);
+
+static struct fcb datalog_fcb;
+static struct flash_sector datalog_sectors[DATALOG_MAX_SECTORS];
+static uint32_t datalog_align;
+static struct datalog_stats datalog_stats;
+static atomic_t datalog_ready;
+static atomic_t datalog_flush_req;
+
+K_FIFO_DEFINE(datalog_fifo);            // Lotes cheios aguardando a gravação
+K_SEM_DEFINE(datalog_flushed, 0, 1);
+K_MUTEX_DEFINE(datalog_mutex);          // Acesso ao FCB (gravação, dump, apagamento)
+
+K_THREAD_STACK_DEFINE(datalog_stack, 1024);
+static struct k_thread datalog_thread_data;
+
+// Lote em montagem (só a adc_thread acessa):
+static struct datalog_batch *datalog_cur;
+static int32_t datalog_prev[ADC_NUM_CHANNELS];
+static uint32_t datalog_next_seq;
+static uint32_t datalog_interval_us;    // Intervalo de varredura do lote (um período por registro)
+static atomic_t datalog_pending;        // Valores no lote em montagem (lido por "log stats")
+
+// Buffer de leitura do dump e da verificação (sob datalog_mutex):
+static uint8_t datalog_read_buf[DATALOG_RECORD_SIZE];
+
+static uint8_t *datalog_put_varint(uint8_t *p, int32_t v)
+{
+    uint32_t z = ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); // zigzag
+
+    while (z >= 0x80) {
+        *p++ = (z & 0x7F) | 0x80;
+        z >>= 7;
+    }
+    *p++ = z;
+    return p;
+}
+
+static const uint8_t *datalog_get_varint(const uint8_t *p, const uint8_t *end, int32_t *v)
+{
+    uint32_t z = 0;
+
+    for (int shift = 0; p < end && shift < 35; shift += 7) {
+        uint8_t b = *p++;
+
+        z |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static void datalog_submit(void)
+{
+    sys_put_le16(datalog_cur->count, &datalog_cur->data[2]);
+    datalog_cur->flush = atomic_cas(&datalog_flush_req, 1, 0);
+    k_fifo_put(&datalog_fifo, datalog_cur);
+    datalog_cur = NULL;
+    atomic_clear(&datalog_pending);
+}
+
+static void datalog_begin(const struct adc_snapshot *snap)
+{
+    struct datalog_batch *b;
+
+    // Sem lote livre, a gravação está atrasada (ex.: apagando um setor):
+    if (k_mem_slab_alloc(&datalog_batches, (void **)&b, K_NO_WAIT) < 0) {
+        datalog_stats.dropped++;
+        return;
+    }
+
+    b->data[0] = DATALOG_VERSION;
+    b->data[1] = ADC_NUM_CHANNELS;
+    sys_put_le32(snap->seq, &b->data[4]);
+    sys_put_le32(k_uptime_get_32(), &b->data[8]);
+    sys_put_le32(ADC_BLOCK_SAMPLES * snap->interval_us, &b->data[12]);
+    for (int ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+        datalog_prev[ch] = snap->channels[ch].voltage_mv;
+        sys_put_le16((uint16_t)datalog_prev[ch], &b->data[DATALOG_HEADER_SIZE + 2 * ch]);
+    }
+    b->len = DATALOG_HEADER_SIZE + 2 * ADC_NUM_CHANNELS;
+    b->count = 1;
+    datalog_cur = b;
+    atomic_set(&datalog_pending, 1);
+    datalog_interval_us = snap->interval_us;
+    datalog_stats.values++;
+}
+
+// Listener do adc_chan (na adc_thread): só codifica na RAM; a flash fica com a
+// thread de gravação.
+static void datalog_adc_cb(const struct zbus_channel *chan)
+{
+    const struct adc_snapshot *snap = zbus_chan_const_msg(chan);
+    uint8_t *p;
+
+    bus_observed(chan);
+
+    if (!atomic_get(&datalog_ready)) {
+        return;
+    }
+
+    // Fecha o lote se estiver cheio, se houver lacuna na sequência, se a taxa mudou
+    // ou a pedido de datalog_flush:
+    if (datalog_cur != NULL &&
+        (snap->seq != datalog_next_seq || snap->interval_us != datalog_interval_us ||
+         atomic_get(&datalog_flush_req) ||
+         datalog_cur->len + ADC_NUM_CHANNELS * DATALOG_VALUE_MAX > DATALOG_RECORD_SIZE)) {
+        datalog_submit();
+    } else if (datalog_cur == NULL && atomic_cas(&datalog_flush_req, 1, 0)) {
+        k_sem_give(&datalog_flushed); // Nada a gravar
+    }
+    datalog_next_seq = snap->seq + 1;
+
+    if (datalog_cur == NULL) {
+        datalog_begin(snap);
+        return;
+    }
+
+    p = &datalog_cur->data[datalog_cur->len];
+    for (int ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+        int32_t mv = snap->channels[ch].voltage_mv;
+
+        p = datalog_put_varint(p, mv - datalog_prev[ch]);
+        datalog_prev[ch] = mv;
+    }
+    datalog_cur->len = p - datalog_cur->data;
+    datalog_cur->count++;
+    atomic_inc(&datalog_pending);
+    datalog_stats.values++;
+}
+
+ZBUS_LISTENER_DEFINE(datalog_adc_lis, datalog_adc_cb);
+ZBUS_CHAN_ADD_OBS(adc_chan, datalog_adc_lis, 4);
+
+static int datalog_append(const uint8_t *data, uint16_t len)
+{
+    struct fcb_entry loc;
+    int ret;
+
+    ret = fcb_append(&datalog_fcb, len, &loc);
+    if (ret == -ENOSPC) {
+        // Log cheio: apaga o setor mais antigo
+        ret = fcb_rotate(&datalog_fcb);
+        if (ret < 0) {
+            return ret;
+        }
+        datalog_stats.erases++;
+        ret = fcb_append(&datalog_fcb, len, &loc);
+    }
+    if (ret < 0) {
+        return ret;
+    }
+
+    ret = flash_area_write(datalog_fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), data,
+                           ROUND_UP(len, datalog_align));
+    if (ret < 0) {
+        return ret;
+    }
+    return fcb_append_finish(&datalog_fcb, &loc);
+}
+
+// Grava um lote por vez, abaixo de todas as threads da aplicação:
+static void datalog_thread(void *a, void *b, void *c)
+{
+    struct datalog_batch *batch;
+    uint32_t start;
+    uint32_t us;
+    bool flush;
+    int ret;
+
+    for (;;) {
+        batch = k_fifo_get(&datalog_fifo, K_FOREVER);
+
+        k_mutex_lock(&datalog_mutex, K_FOREVER);
+        start = k_cycle_get_32();
+        ret = datalog_append(batch->data, batch->len);
+        us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+        k_mutex_unlock(&datalog_mutex);
+
+        if (ret < 0) {
+            datalog_stats.errors++;
+        } else {
+            // Cabeçalho do FCB: tamanho (1 ou 2 bytes) e CRC-8, cada um alinhado
+            datalog_stats.records++;
+            datalog_stats.payload_bytes += batch->len;
+            datalog_stats.flash_bytes += ROUND_UP(batch->len < 0x80 ? 1 : 2, datalog_align) +
+                                         ROUND_UP(batch->len, datalog_align) +
+                                         ROUND_UP(1, datalog_align);
+        }
+        datalog_stats.flash_us += us;
+        datalog_stats.max_us = MAX(datalog_stats.max_us, us);
+
+        flush = batch->flush;
+        k_mem_slab_free(&datalog_batches, batch);
+        if (flush) {
+            k_sem_give(&datalog_flushed);
+        }
+    }
+}
+
+int datalog_init(void)
+{
+    const struct flash_area *fa;
+    uint32_t count = ARRAY_SIZE(datalog_sectors);
+    int ret;
+
+    ret = flash_area_get_sectors(DATALOG_PARTITION, &count, datalog_sectors);
+    if (ret < 0) {
+        return ret;
+    }
+
+    datalog_fcb.f_magic = DATALOG_MAGIC;
+    datalog_fcb.f_version = DATALOG_VERSION;
+    datalog_fcb.f_sector_cnt = count;
+    datalog_fcb.f_scratch_cnt = 0;
+    datalog_fcb.f_sectors = datalog_sectors;
+
+    ret = fcb_init(DATALOG_PARTITION, &datalog_fcb);
+    if (ret < 0) {
+        // Partição com outro conteúdo (ou versão antiga do log): começa do zero
+        ret = flash_area_open(DATALOG_PARTITION, &fa);
+        if (ret < 0) {
+            return ret;
+        }
+        ret = flash_area_erase(fa, 0, fa->fa_size);
+        flash_area_close(fa);
+        if (ret < 0) {
+            return ret;
+        }
+        ret = fcb_init(DATALOG_PARTITION, &datalog_fcb);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+    datalog_align = flash_area_align(datalog_fcb.fap);
+
+    k_thread_create(&datalog_thread_data, datalog_stack, K_THREAD_STACK_SIZEOF(datalog_stack),
+                    datalog_thread, NULL, NULL, NULL, DATALOG_PRIORITY, 0, K_NO_WAIT);
+    k_thread_name_set(&datalog_thread_data, "datalog");
+
+    atomic_set(&datalog_ready, 1);
+    return 0;
+}
+
+int datalog_flush(k_timeout_t timeout)
+{
+    if (!atomic_get(&datalog_ready)) {
+        return -ENODEV;
+    }
+
+    k_sem_reset(&datalog_flushed);
+    atomic_set(&datalog_flush_req, 1);
+
+    return k_sem_take(&datalog_flushed, timeout);
+}
+
+// Lê o registro atual de um fcb_walk para datalog_read_buf:
+static int datalog_read(struct fcb_entry_ctx *ctx, uint16_t *len)
+{
+    *len = MIN(ctx->loc.fe_data_len, sizeof(datalog_read_buf));
+    return flash_area_read(ctx->fap, FCB_ENTRY_FA_DATA_OFF(ctx->loc), datalog_read_buf, *len);
+}
+
+struct datalog_walk {
+    uint32_t records;
+    uint32_t bytes;
+    uint32_t values;
+    uint32_t errors;
+    int32_t expected_mv;
+    int32_t tol_mv;
+    int ret;
+};
+
+static int datalog_count_cb(struct fcb_entry_ctx *ctx, void *arg)
+{
+    struct datalog_walk *w = arg;
+
+    w->records++;
+    w->bytes += ctx->loc.fe_data_len;
+    return 0;
+}
+
+static int datalog_dump_cb(struct fcb_entry_ctx *ctx, void *arg)
+{
+    struct datalog_walk *w = arg;
+    uint8_t header[5];
+    uint16_t len;
+
+    w->ret = datalog_read(ctx, &len);
+    if (w->ret < 0) {
+        return 1;
+    }
+
+    header[0] = TELEMETRY_TYPE_LOG_RECORD;
+    sys_put_le32(w->records, &header[1]);
+
+    // Espera a UART liberar um quadro: o dump segue na velocidade da porta
+    w->ret = telemetry_send_packet(&datalog_dump_frames, header, sizeof(header),
+                                   datalog_read_buf, len, K_FOREVER);
+    if (w->ret < 0) {
+        return 1;
+    }
+
+    w->records++;
+    w->bytes += len;
+    return 0;
+}
+
+static int datalog_check_cb(struct fcb_entry_ctx *ctx, void *arg)
+{
+    struct datalog_walk *w = arg;
+    const uint8_t *p;
+    const uint8_t *end;
+    int32_t prev[ADC_NUM_CHANNELS];
+    uint16_t count;
+    uint16_t len;
+
+    w->records++;
+    if (datalog_read(ctx, &len) < 0 || len < DATALOG_HEADER_SIZE + 2 * ADC_NUM_CHANNELS ||
+        datalog_read_buf[0] != DATALOG_VERSION || datalog_read_buf[1] != ADC_NUM_CHANNELS) {
+        w->errors++;
+        return 0;
+    }
+
+    count = sys_get_le16(&datalog_read_buf[2]);
+    p = &datalog_read_buf[DATALOG_HEADER_SIZE];
+    end = &datalog_read_buf[len];
+
+    for (uint16_t i = 0; i < count; i++) {
+        for (int ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+            int32_t delta;
+
+            if (i == 0) {
+                prev[ch] = (int16_t)sys_get_le16(p);
+                p += 2;
+            } else {
+                p = datalog_get_varint(p, end, &delta);
+                if (p == NULL) {
+                    w->errors++; // Registro truncado
+                    return 0;
+                }
+                prev[ch] += delta;
+            }
+
+            w->values++;
+            if (prev[ch] < w->expected_mv - w->tol_mv || prev[ch] > w->expected_mv + w->tol_mv) {
+                w->errors++;
+            }
+        }
+    }
+    return 0;
+}
+
+int datalog_check(int32_t expected_mv, int32_t tol_mv)
+{
+    struct datalog_walk w = { .expected_mv = expected_mv, .tol_mv = tol_mv };
+
+    if (datalog_flush(K_MSEC(DATALOG_FLUSH_TIMEOUT_MS)) < 0) {
+        printk("LOG_CHECK flush failed\n");
+        return -EIO;
+    }
+
+    k_mutex_lock(&datalog_mutex, K_FOREVER);
+    fcb_walk(&datalog_fcb, NULL, datalog_check_cb, &w);
+    k_mutex_unlock(&datalog_mutex);
+
+    printk("LOG_CHECK,%u,%u,%u\n", w.records, w.values, w.errors);
+    return w.errors ? -EIO : 0;
+}
+
+static int datalog_dump(void)
+{
+    static const uint8_t delimiter = 0x00;
+    struct datalog_walk w = { 0 };
+    uint8_t end[9];
+    uint32_t start = k_uptime_get_32();
+
+    // Inclui os valores que ainda estão no lote em montagem:
+    datalog_flush(K_MSEC(DATALOG_FLUSH_TIMEOUT_MS));
+
+    // Delimitador: descarta o texto que o decodificador já recebeu antes do primeiro quadro
+    uart_io_write(&delimiter, 1);
+
+    k_mutex_lock(&datalog_mutex, K_FOREVER);
+    fcb_walk(&datalog_fcb, NULL, datalog_dump_cb, &w);
+    k_mutex_unlock(&datalog_mutex);
+
+    end[0] = TELEMETRY_TYPE_LOG_END;
+    sys_put_le32(w.records, &end[1]);
+    sys_put_le32(w.bytes, &end[5]);
+    telemetry_send_packet(&datalog_dump_frames, end, sizeof(end), NULL, 0, K_FOREVER);
+
+    uart_io_printf("\nLog dump: %u records, %u bytes in %u ms\n", w.records, w.bytes,
+                   k_uptime_get_32() - start);
+    return w.ret;
+}
+
+static void datalog_print_stats(void)
+{
+    struct datalog_stats s = datalog_stats;
+    struct datalog_walk w = { 0 };
+    uint32_t raw_bytes = s.values * ADC_NUM_CHANNELS * sizeof(int16_t);
+    int free_sectors;
+
+    k_mutex_lock(&datalog_mutex, K_FOREVER);
+    fcb_walk(&datalog_fcb, NULL, datalog_count_cb, &w);
+    free_sectors = fcb_free_sector_cnt(&datalog_fcb);
+    k_mutex_unlock(&datalog_mutex);
+
+    uart_io_printf("\n=== DATA LOG ===\n");
+    uart_io_printf("Sectors:      %u (%d free), %u-byte records\n", datalog_fcb.f_sector_cnt,
+                   free_sectors, DATALOG_RECORD_SIZE);
+    uart_io_printf("In flash:     %u records, %u bytes\n", w.records, w.bytes);
+    uart_io_printf("Values:       %u logged, %u dropped, %u pending in RAM\n", s.values, s.dropped,
+                   (uint32_t)atomic_get(&datalog_pending));
+    if (s.payload_bytes > 0) {
+        uart_io_printf("Encoding:     %u bytes for %u raw (%u%%)\n", s.payload_bytes, raw_bytes,
+                       (uint32_t)((uint64_t)s.payload_bytes * 100 / MAX(raw_bytes, 1)));
+        uart_io_printf("Flash writes: %u bytes (x%u.%02u), %u erases, %u errors\n", s.flash_bytes,
+                       s.flash_bytes / s.payload_bytes,
+                       (uint32_t)((uint64_t)(s.flash_bytes % s.payload_bytes) * 100 / s.payload_bytes),
+                       s.erases, s.errors);
+        uart_io_printf("Flash time:   %u ms total, %u us avg, %u us max per record\n",
+                       (uint32_t)(s.flash_us / 1000),
+                       (uint32_t)(s.flash_us / MAX(s.records + s.errors, 1)), s.max_us);
+    }
+    uart_io_printf("================\n\n");
+}
+
+// Comando "log stats|dump|erase":
+static int cmd_log(int argc, char *argv[])
+{
+    int ret;
+
+    if (!atomic_get(&datalog_ready)) {
+        uart_io_printf("Data log not available\n");
+        return -ENODEV;
+    }
+
+    if (strcmp(argv[1], "stats") == 0) {
+        datalog_print_stats();
+    } else if (strcmp(argv[1], "dump") == 0) {
+        return datalog_dump();
+    } else if (strcmp(argv[1], "erase") == 0) {
+        k_mutex_lock(&datalog_mutex, K_FOREVER);
+        ret = fcb_clear(&datalog_fcb);
+        k_mutex_unlock(&datalog_mutex);
+        if (ret < 0) {
+            return ret;
+        }
+        uart_io_printf("Data log erased\n");
+    } else {
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+APP_CMD_DEFINE(log, "log", cmd_log, "<stats|dump|erase>", 1, 1,
+               "Flash data log: statistics, binary dump or erase");
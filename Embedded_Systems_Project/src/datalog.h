@@ -0,0 +1,33 @@
+#ifndef DATALOG_H
+#define DATALOG_H
+
+#include "config.h"
+
+// Registrador de dados na flash: cada valor publicado pelo ADC é codificado em
+// um lote na RAM, e cada lote cheio vira um registro no log circular (FCB) da
+// partição log_partition, gravado por uma thread de baixa prioridade.
+//
+// Formato do registro (little-endian):
+//   u8  version     DATALOG_VERSION
+//   u8  channels
+//   u16 count       valores por canal
+//   u32 seq         bloco de aquisição do primeiro valor (os demais são consecutivos)
+//   u32 uptime_ms   k_uptime_get_32 do primeiro valor
+//   u32 period_us   intervalo entre valores
+//   i16 first[channels]           primeiro valor de cada canal, em mV
+//   varint delta[(count - 1) * channels]  diferença para o valor anterior do mesmo
+//                                 canal, zigzag + LEB128 (1 byte para |d| < 64 mV)
+#define DATALOG_VERSION     1
+#define DATALOG_HEADER_SIZE 16
+
+// Abre o log na flash e cria a thread de gravação:
+int datalog_init(void);
+
+// Grava o lote em montagem e espera até timeout pela gravação (0 ou -EAGAIN):
+int datalog_flush(k_timeout_t timeout);
+
+// Percorre o log e confere se os valores estão a até tol_mv de expected_mv
+// (teste com o ADC emulado). Imprime LOG_CHECK,<records>,<values>,<errors>.
+int datalog_check(int32_t expected_mv, int32_t tol_mv);
+
+#endif /* DATALOG_H */
@@ -0,0 +1,165 @@
+#include "display_sched.h"
+#include "uart_io.h"
+#include "cmd.h"
+#include "bus.h"
+#include <stdlib.h>
+
+K_SEM_DEFINE(display_update_sem, 0, 1); // Há pelo menos um evento pendente
+
+// Ajustes do comando "display" (escritos pela uart_thread, lidos a cada quadro):
+static uint32_t display_max_fps = DISPLAY_MAX_FPS;
+static uint32_t display_coalesce_ms = DISPLAY_COALESCE_MS;
+static uint32_t display_deadband_mv = DISPLAY_DEADBAND_MV;
+static uint32_t display_deadband_pct = DISPLAY_DEADBAND_PCT;
+
+// Último valor do ADC que gerou um quadro (só a adc_thread acessa):
+static int32_t sched_mv[ADC_NUM_CHANNELS];
+static uint8_t sched_pct;
+static bool sched_valid;
+
+static uint32_t last_frame_ms;
+
+// Contadores para o comando "display":
+static atomic_t display_events;     // Pedidos de quadro aceitos
+static atomic_t display_suppressed; // Leituras descartadas pela banda morta
+static atomic_t display_frames;     // Quadros liberados para a display_thread
+
+void display_sched_request(void)
+{
+    atomic_inc(&display_events);
+    k_sem_give(&display_update_sem);
+}
+
+// Listener do adc_chan (na adc_thread): aplica a banda morta sem copiar o valor.
+static void display_adc_cb(const struct zbus_channel *chan)
+{
+    const struct adc_snapshot *snap = zbus_chan_const_msg(chan);
+    bool changed;
+
+    bus_observed(chan);
+
+    changed = !sched_valid ||
+              abs((int)snap->percentage - (int)sched_pct) > (int)display_deadband_pct;
+
+    for (int ch = 0; ch < ADC_NUM_CHANNELS && !changed; ch++) {
+        changed = abs(snap->channels[ch].voltage_mv - sched_mv[ch]) > (int32_t)display_deadband_mv;
+    }
+
+    if (!changed) {
+        atomic_inc(&display_suppressed);
+        return;
+    }
+
+    for (int ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+        sched_mv[ch] = snap->channels[ch].voltage_mv;
+    }
+    sched_pct = snap->percentage;
+    sched_valid = true;
+
+    display_sched_request();
+}
+
+ZBUS_LISTENER_DEFINE(display_adc_lis, display_adc_cb);
+ZBUS_CHAN_ADD_OBS(adc_chan, display_adc_lis, 1);
+
+// Listener do led_chan: o estado do LED sempre aparece na tela.
+static void display_led_cb(const struct zbus_channel *chan)
+{
+    bus_observed(chan);
+    display_sched_request();
+}
+
+ZBUS_LISTENER_DEFINE(display_led_lis, display_led_cb);
+ZBUS_CHAN_ADD_OBS(led_chan, display_led_lis, 1);
+
+// Listener do cmd_chan: um comando pode mudar o que aparece na tela (ex.: "chart",
+// "cal", "display"), então cada comando executado pede um quadro.
+static void display_cmd_cb(const struct zbus_channel *chan)
+{
+    bus_observed(chan);
+    display_sched_request();
+}
+
+ZBUS_LISTENER_DEFINE(display_cmd_lis, display_cmd_cb);
+ZBUS_CHAN_ADD_OBS(cmd_chan, display_cmd_lis, 1);
+
+void display_sched_wait(void)
+{
+    uint32_t interval_ms = 1000 / display_max_fps;
+    uint32_t elapsed;
+
+    k_sem_take(&display_update_sem, K_FOREVER);
+
+    // Janela de coalescência: eventos que chegarem aqui entram neste mesmo quadro.
+    if (display_coalesce_ms > 0) {
+        k_msleep(display_coalesce_ms);
+    }
+
+    // Limite de quadros por segundo:
+    elapsed = k_uptime_get_32() - last_frame_ms;
+    if (elapsed < interval_ms) {
+        k_msleep(interval_ms - elapsed);
+    }
+
+    // O quadro lê o estado atual, então eventos da espera já estão cobertos:
+    k_sem_reset(&display_update_sem);
+    last_frame_ms = k_uptime_get_32();
+    atomic_inc(&display_frames);
+}
+
+static void display_print_config(void)
+{
+    uart_io_printf("Display: max %u fps, coalesce %u ms, deadband %u mV / %u %%\n",
+                   display_max_fps, display_coalesce_ms, display_deadband_mv,
+                   display_deadband_pct);
+}
+
+static int cmd_display(int argc, char *argv[])
+{
+    uint32_t value;
+
+    if (argc == 1) {
+        uint32_t events = atomic_get(&display_events);
+        uint32_t frames = atomic_get(&display_frames);
+
+        display_print_config();
+        uart_io_printf("- Events:    %u\n", events);
+        uart_io_printf("- Frames:    %u (%u events merged)\n", frames,
+                       events > frames ? events - frames : 0);
+        uart_io_printf("- Deadband:  %u ADC readings skipped\n",
+                       (uint32_t)atomic_get(&display_suppressed));
+        return 0;
+    }
+
+    if (strcmp(argv[1], "fps") == 0 && argc == 3) {
+        if (cmd_parse_u32(argv[2], 1, DISPLAY_MAX_FPS_LIMIT, &value) < 0) {
+            return -EINVAL;
+        }
+        display_max_fps = value;
+    } else if (strcmp(argv[1], "coalesce") == 0 && argc == 3) {
+        if (cmd_parse_u32(argv[2], 0, 1000, &value) < 0) {
+            return -EINVAL;
+        }
+        display_coalesce_ms = value;
+    } else if (strcmp(argv[1], "deadband") == 0) {
+        if (argc < 3 || cmd_parse_u32(argv[2], 0, 3300, &value) < 0) {
+            return -EINVAL;
+        }
+        display_deadband_mv = value;
+        if (argc == 4) {
+            if (cmd_parse_u32(argv[3], 0, 100, &value) < 0) {
+                return -EINVAL;
+            }
+            display_deadband_pct = value;
+        }
+    } else {
+        return -EINVAL;
+    }
+
+    display_print_config();
+    return 0;
+}
+
+APP_CMD_DEFINE(display, "display", cmd_display,
+               "[fps <1-60>|coalesce <ms>|deadband <mV> [pct]]", 0, 3,
+               "Show or set display frame rate, coalescing and deadband");
@@ -0,0 +1,19 @@
+#ifndef DISPLAY_SCHED_H
+#define DISPLAY_SCHED_H
+
+#include "config.h"
+
+// Agendador de quadros do display: junta rajadas de eventos em um único quadro,
+// limita a taxa de quadros e ignora leituras do ADC dentro da banda morta.
+// Observa o led_chan e o cmd_chan (todo novo estado ou comando pede quadro) e o
+// adc_chan (só pede quadro se algum canal sair da banda morta em relação ao
+// último valor enviado ao display).
+
+// Pede um quadro por uma mudança que sempre aparece na tela (boot, invalidação):
+void display_sched_request(void);
+
+// display_thread: bloqueia até o próximo quadro, respeitando a janela de
+// coalescência e o intervalo mínimo entre quadros.
+void display_sched_wait(void);
+
+#endif /* DISPLAY_SCHED_H */
@@ -0,0 +1,282 @@
+#include "filter.h"
+#include "uart_io.h"
+#include "cmd.h"
+#include <stdlib.h>
+#include <arm_math.h>
+
+// As amostras de 12 bits são escaladas para ocupar a faixa Q15, o que preserva
+// a resolução nos produtos e no estado dos filtros:
+#define FILTER_INPUT_SHIFT (15 - ADC_RESOLUTION)
+
+struct filter_config {
+    enum filter_type type;
+    uint16_t n;                          // Janela (avg/median) ou número de coeficientes (fir)
+    int16_t alpha;                       // Coeficiente do IIR (Q15)
+    int16_t taps[FILTER_MAX_TAPS];       // Coeficientes do FIR (Q15)
+};
+
+static const char *const filter_names[] = {
+    [FILTER_NONE] = "none",
+    [FILTER_AVG] = "avg",
+    [FILTER_MEDIAN] = "median",
+    [FILTER_IIR] = "iir",
+    [FILTER_FIR] = "fir",
+};
+
+// Configuração pedida pelo comando, aplicada pela adc_thread no próximo bloco:
+static struct filter_config filter_pending;
+static atomic_t filter_pending_set = ATOMIC_INIT(0);
+static struct k_spinlock filter_lock;
+
+// Estado usado só pela adc_thread:
+static struct filter_config filter_active;
+// (coeficientes compartilhados, estado separado por canal):
+static q15_t filter_coeffs[FILTER_MAX_TAPS + 1];  // +1: o FIR exige número par de coeficientes
+static arm_fir_instance_q15 filter_fir[ADC_NUM_CHANNELS];
+static arm_biquad_casd_df1_inst_q15 filter_iir[ADC_NUM_CHANNELS];
+static q15_t filter_state[ADC_NUM_CHANNELS][FILTER_MAX_TAPS + ADC_BLOCK_SAMPLES];
+static uint16_t filter_median_pos[ADC_NUM_CHANNELS];
+static q15_t filter_work[ADC_BLOCK_SAMPLES];
+static uint32_t filter_cycles;                    // Custo do último bloco (todos os canais), para o comando "filter"
+
+static void filter_apply_config(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&filter_lock);
+
+    filter_active = filter_pending;
+    atomic_clear(&filter_pending_set);
+    k_spin_unlock(&filter_lock, key);
+
+    memset(filter_state, 0, sizeof(filter_state));
+    memset(filter_median_pos, 0, sizeof(filter_median_pos));
+
+    switch (filter_active.type) {
+    case FILTER_AVG:
+    case FILTER_FIR: {
+        // arm_fir_fast_q15 exige ao menos 4 coeficientes, em número par (completa com zeros):
+        uint16_t taps = MAX(ROUND_UP(filter_active.n, 2), 4);
+
+        // O CMSIS-DSP espera os coeficientes invertidos no tempo ({b[N-1] ... b[0]}):
+        // b[0] vai para o fim e os zeros do preenchimento ficam nos últimos coeficientes.
+        memset(filter_coeffs, 0, sizeof(filter_coeffs));
+        for (int i = 0; i < filter_active.n; i++) {
+            filter_coeffs[taps - 1 - i] = (filter_active.type == FILTER_AVG)
+                             ? (q15_t)MIN(32768 / filter_active.n, INT16_MAX)
+                             : filter_active.taps[i];
+        }
+        for (int ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+            arm_fir_init_q15(&filter_fir[ch], taps, filter_coeffs, filter_state[ch], ADC_BLOCK_SAMPLES);
+        }
+        break;
+    }
+    case FILTER_IIR:
+        // Um estágio biquad {b0, 0, b1, b2, a1, a2} com b0 = alpha e a1 = 1 - alpha:
+        filter_coeffs[0] = filter_active.alpha;
+        filter_coeffs[1] = 0;
+        filter_coeffs[2] = 0;
+        filter_coeffs[3] = 0;
+        filter_coeffs[4] = (q15_t)MIN(32768 - filter_active.alpha, INT16_MAX);
+        filter_coeffs[5] = 0;
+        for (int ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+            arm_biquad_cascade_df1_init_q15(&filter_iir[ch], 1, filter_coeffs, filter_state[ch], 0);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// Mediana por ordenação por inserção da janela (N <= FILTER_MAX_TAPS, sem kernel no CMSIS-DSP):
+static void filter_median(uint8_t ch, const q15_t *in, q15_t *out, uint16_t count)
+{
+    uint16_t n = filter_active.n;
+    q15_t *window = filter_state[ch];
+    q15_t sorted[FILTER_MAX_TAPS];
+
+    for (int s = 0; s < count; s++) {
+        window[filter_median_pos[ch]] = in[s];
+        filter_median_pos[ch] = (filter_median_pos[ch] + 1) % n;
+
+        for (int i = 0; i < n; i++) {
+            q15_t v = window[i];
+            int j = i;
+
+            while (j > 0 && sorted[j - 1] > v) {
+                sorted[j] = sorted[j - 1];
+                j--;
+            }
+            sorted[j] = v;
+        }
+        out[s] = sorted[n / 2];
+    }
+}
+
+void filter_process(uint8_t ch, const int16_t *in, int16_t *out, uint16_t count)
+{
+    uint32_t start = k_cycle_get_32();
+
+    // A configuração só muda entre blocos, para todos os canais juntos:
+    if (ch == 0) {
+        if (atomic_get(&filter_pending_set)) {
+            filter_apply_config();
+        }
+        filter_cycles = 0;
+    }
+
+    if (filter_active.type == FILTER_NONE) {
+        memcpy(out, in, count * sizeof(int16_t));
+        filter_cycles += k_cycle_get_32() - start;
+        return;
+    }
+
+    arm_shift_q15(in, FILTER_INPUT_SHIFT, filter_work, count);
+
+    switch (filter_active.type) {
+    case FILTER_AVG:
+    case FILTER_FIR:
+        arm_fir_fast_q15(&filter_fir[ch], filter_work, out, count);
+        break;
+    case FILTER_IIR:
+        arm_biquad_cascade_df1_q15(&filter_iir[ch], filter_work, out, count);
+        break;
+    case FILTER_MEDIAN:
+        filter_median(ch, filter_work, out, count);
+        break;
+    default:
+        break;
+    }
+
+    arm_shift_q15(out, -FILTER_INPUT_SHIFT, out, count);
+    filter_cycles += k_cycle_get_32() - start;
+}
+
+static void filter_request(const struct filter_config *cfg)
+{
+    k_spinlock_key_t key = k_spin_lock(&filter_lock);
+
+    filter_pending = *cfg;
+    atomic_set(&filter_pending_set, 1);
+    k_spin_unlock(&filter_lock, key);
+}
+
+// Verificação do FIR no boot (CI): uma rampa passa por kernels assimétricos no
+// canal 0 e a saída é comparada com a entrada atrasada de delay amostras.
+struct filter_check_case {
+    uint16_t n;
+    int16_t taps[4];
+    uint16_t delay;
+};
+
+int filter_check(void)
+{
+    static const struct filter_check_case cases[] = {
+        { 4, { 32767, 0, 0, 0 }, 0 },  // Passa direto, sem atraso
+        { 3, { 32767, 0, 0 }, 0 },     // Idem, com um zero de preenchimento
+        { 2, { 0, 32767 }, 1 },        // Uma amostra de atraso
+    };
+    int16_t in[ADC_BLOCK_SAMPLES];
+    int16_t out[ADC_BLOCK_SAMPLES];
+    struct filter_config cfg = { .type = FILTER_FIR };
+    uint32_t errors = 0;
+
+    for (int i = 0; i < ADC_BLOCK_SAMPLES; i++) {
+        in[i] = 100 + 37 * i;
+    }
+
+    for (size_t c = 0; c < ARRAY_SIZE(cases); c++) {
+        cfg.n = cases[c].n;
+        memcpy(cfg.taps, cases[c].taps, sizeof(cases[c].taps));
+        filter_request(&cfg);
+        filter_process(0, in, out, ADC_BLOCK_SAMPLES);
+
+        // Ganho de 32767/32768: tolera um código de truncamento
+        for (int i = 0; i < ADC_BLOCK_SAMPLES; i++) {
+            int16_t expected = i >= cases[c].delay ? in[i - cases[c].delay] : 0;
+
+            if (abs(out[i] - expected) > 1) {
+                errors++;
+            }
+        }
+    }
+
+    // A adc_thread volta a encontrar o filtro desligado, com o estado zerado:
+    cfg = (struct filter_config){ .type = FILTER_NONE };
+    filter_request(&cfg);
+
+    printk("FILTER_CHECK,%u,%u\n", (uint32_t)ARRAY_SIZE(cases), errors);
+    return errors ? -EIO : 0;
+}
+
+static int filter_parse_q15(const char *arg, int16_t *value)
+{
+    char *end;
+    long v = strtol(arg, &end, 10);
+
+    if (end == arg || *end != '\0' || v < INT16_MIN || v > INT16_MAX) {
+        return -EINVAL;
+    }
+
+    *value = (int16_t)v;
+    return 0;
+}
+
+// Comando "filter [none|avg <n>|median <n>|iir <alpha>|fir <taps...>]".
+// alpha e os coeficientes do FIR são inteiros Q15 (32767 = 1,0).
+static int cmd_filter(int argc, char *argv[])
+{
+    struct filter_config cfg = { 0 };
+    uint32_t v;
+
+    if (argc == 1) {
+        uart_io_printf("Filter: %s", filter_names[filter_active.type]);
+        if (filter_active.type == FILTER_IIR) {
+            uart_io_printf(" alpha=%d", filter_active.alpha);
+        } else if (filter_active.type != FILTER_NONE) {
+            uart_io_printf(" n=%u", filter_active.n);
+        }
+        uart_io_printf(", %u cycles/block (%u us)\n", filter_cycles,
+                       k_cyc_to_us_floor32(filter_cycles));
+        return 0;
+    }
+
+    if (strcmp(argv[1], "none") == 0 && argc == 2) {
+        cfg.type = FILTER_NONE;
+    } else if (strcmp(argv[1], "avg") == 0 && argc == 3) {
+        if (cmd_parse_u32(argv[2], 2, FILTER_MAX_TAPS, &v) < 0) {
+            return -EINVAL;
+        }
+        cfg.type = FILTER_AVG;
+        cfg.n = v;
+    } else if (strcmp(argv[1], "median") == 0 && argc == 3) {
+        if (cmd_parse_u32(argv[2], 3, FILTER_MAX_TAPS, &v) < 0 || (v % 2) == 0) {
+            return -EINVAL;
+        }
+        cfg.type = FILTER_MEDIAN;
+        cfg.n = v;
+    } else if (strcmp(argv[1], "iir") == 0 && argc == 3) {
+        if (filter_parse_q15(argv[2], &cfg.alpha) < 0 || cfg.alpha <= 0) {
+            return -EINVAL;
+        }
+        cfg.type = FILTER_IIR;
+    } else if (strcmp(argv[1], "fir") == 0 && argc >= 3) {
+        cfg.type = FILTER_FIR;
+        cfg.n = argc - 2;
+        for (int i = 0; i < cfg.n; i++) {
+            if (filter_parse_q15(argv[i + 2], &cfg.taps[i]) < 0) {
+                return -EINVAL;
+            }
+        }
+    } else {
+        return -EINVAL;
+    }
+
+    filter_request(&cfg);
+    uart_io_printf("Filter set to %s\n", filter_names[cfg.type]);
+
+    return 0;
+}
+
+BUILD_ASSERT(FILTER_MAX_TAPS + 1 <= CMD_MAX_ARGS, "the dispatcher must accept 'fir' plus every tap");
+
+APP_CMD_DEFINE(filter, "filter", cmd_filter, "[none|avg n|median n|iir a|fir t1..t31]", 0,
+               FILTER_MAX_TAPS + 1, "Select the ADC sample filter");
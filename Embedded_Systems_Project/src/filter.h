@@ -0,0 +1,26 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include "config.h"
+
+// Filtros aplicados às amostras brutas antes da decimação:
+enum filter_type {
+    FILTER_NONE,
+    FILTER_AVG,     // Média móvel de N amostras
+    FILTER_MEDIAN,  // Mediana das últimas N amostras (N ímpar)
+    FILTER_IIR,     // Passa-baixas de um polo: y += alpha * (x - y)
+    FILTER_FIR,     // FIR com coeficientes Q15 fornecidos pelo usuário
+};
+
+// Filtra count amostras (count <= ADC_BLOCK_SAMPLES) do canal ch de in para out,
+// mantendo o estado de cada canal entre blocos. Chamado só pela adc_thread, um
+// canal por vez a partir do 0; no canal 0 aplica qualquer configuração nova
+// enviada pelo comando "filter".
+void filter_process(uint8_t ch, const int16_t *in, int16_t *out, uint16_t count);
+
+// Passa uma rampa por FIRs assimétricos no canal 0 e confere a ordem dos
+// coeficientes (imprime FILTER_CHECK,<casos>,<erros>). Só antes da adc_thread
+// começar, pois usa o estado do canal 0:
+int filter_check(void);
+
+#endif /* FILTER_H */
@@ -0,0 +1,105 @@
+#include "latency.h"
+#include "uart_io.h"
+#include "cmd.h"
+
+// Histograma com baldes de potência de 2 em microssegundos: o balde i conta
+// durações em [2^(i-1), 2^i) us (o balde 0 conta durações abaixo de 1 us).
+struct latency_hist {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[LATENCY_BUCKETS];
+};
+
+static const char *const latency_stage_names[LAT_STAGE_COUNT] = {
+    [LAT_ADC_WAKE]     = "adc isr->thread",
+    [LAT_ADC_PROCESS]  = "adc process",
+    [LAT_DISPLAY_WAKE] = "publish->display",
+    [LAT_DISPLAY_DRAW] = "display render",
+    [LAT_END_TO_END]   = "adc isr->pixels",
+    [LAT_ALARM_GPIO]   = "alarm sample->gpio",
+    [LAT_ALARM_LED]    = "alarm sample->led",
+};
+
+static struct latency_hist latency_hists[LAT_STAGE_COUNT];
+static struct k_spinlock latency_lock;
+
+void latency_record(enum latency_stage stage, uint32_t cycles)
+{
+    struct latency_hist *h = &latency_hists[stage];
+    uint32_t us = k_cyc_to_us_floor32(cycles);
+    uint32_t bucket = (us == 0) ? 0 : MIN(32 - __builtin_clz(us), LATENCY_BUCKETS - 1);
+    k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+    if (h->count == 0 || us < h->min_us) {
+        h->min_us = us;
+    }
+    if (us > h->max_us) {
+        h->max_us = us;
+    }
+    h->count++;
+    h->sum_us += us;
+    h->buckets[bucket]++;
+
+    k_spin_unlock(&latency_lock, key);
+}
+
+void latency_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+    memset(latency_hists, 0, sizeof(latency_hists));
+    k_spin_unlock(&latency_lock, key);
+}
+
+// Limite superior (em us) do balde que contém o percentil 99:
+static uint32_t latency_p99(const struct latency_hist *h)
+{
+    uint32_t target = h->count - h->count / 100;
+    uint32_t seen = 0;
+
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= target) {
+            return MIN(BIT(i), h->max_us);
+        }
+    }
+    return h->max_us;
+}
+
+// Comando "latency [reset]":
+static int cmd_latency(int argc, char *argv[])
+{
+    struct latency_hist h;
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "reset") != 0) {
+            return -EINVAL;
+        }
+        latency_reset();
+        uart_io_printf("Latency histograms cleared\n");
+        return 0;
+    }
+
+    uart_io_printf("\n=== LATENCY (us) ===\n");
+    uart_io_printf("%-18s %8s %8s %8s %8s %8s\n", "Stage", "Count", "Min", "Mean", "P99", "Max");
+    for (int i = 0; i < LAT_STAGE_COUNT; i++) {
+        k_spinlock_key_t key = k_spin_lock(&latency_lock);
+        h = latency_hists[i];
+        k_spin_unlock(&latency_lock, key);
+
+        if (h.count == 0) {
+            uart_io_printf("%-18s %8u %8s %8s %8s %8s\n", latency_stage_names[i], 0U, "-", "-", "-", "-");
+            continue;
+        }
+        uart_io_printf("%-18s %8u %8u %8u %8u %8u\n", latency_stage_names[i], h.count, h.min_us,
+                       (uint32_t)(h.sum_us / h.count), latency_p99(&h), h.max_us);
+    }
+    uart_io_printf("====================\n\n");
+
+    return 0;
+}
+
+APP_CMD_DEFINE(latency, "latency", cmd_latency, "[reset]", 0, 1,
+               "Show ADC-to-display and alarm latency histograms");
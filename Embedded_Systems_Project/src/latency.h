@@ -0,0 +1,23 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include "config.h"
+
+// Etapas medidas no caminho amostra -> pixels:
+enum latency_stage {
+    LAT_ADC_WAKE,       // Fim do bloco (callback do ADC) -> adc_thread recebe o bloco
+    LAT_ADC_PROCESS,    // adc_thread: decimação, conversão e publicação
+    LAT_DISPLAY_WAKE,   // Publicação -> display_thread começa o quadro
+    LAT_DISPLAY_DRAW,   // Renderização dos campos alterados até o último trecho enfileirado
+    LAT_END_TO_END,     // Fim do bloco -> último trecho escrito pela thread display_tx
+    LAT_ALARM_GPIO,     // Amostra no callback do ADC -> GPIO de alarme atualizado
+    LAT_ALARM_LED,      // Amostra no callback do ADC -> LED atualizado pela thread de alarmes
+    LAT_STAGE_COUNT
+};
+
+// Registra uma duração, em ciclos de clock (diferença de k_cycle_get_32):
+void latency_record(enum latency_stage stage, uint32_t cycles);
+
+void latency_reset(void);
+
+#endif /* LATENCY_H */
@@ -1,222 +1,92 @@
 #include "config.h"
+#include "adc_acq.h"
+#include "text_display.h"
+#include "adc_snapshot.h"
+#include "uart_io.h"
+#include "cmd.h"
+#include "telemetry.h"
+#include "latency.h"
+#include "bench.h"
+#include "thread_stats.h"
+#include "filter.h"
+#include "pwm_out.h"
+#include "display_sched.h"
+#include "bus.h"
+#include "chart.h"
+#include "datalog.h"
+#include "calib.h"
+#include "alarm.h"
+#include "power.h"
+#if defined(CONFIG_ADC_EMUL)
+#include <zephyr/drivers/adc/adc_emul.h>
+#endif
 
 // Definição das threads e suas pilhas:
-K_THREAD_STACK_DEFINE(blink_thread_stack, 512);   // Thread para piscar o LED
-K_THREAD_STACK_DEFINE(uart_thread_stack, 512);    // Thread para UART
-K_THREAD_STACK_DEFINE(adc_thread_stack, 512);     // Thread para ADC
-K_THREAD_STACK_DEFINE(display_thread_stack, 512); // Thread para display
-static struct k_thread blink_thread_data;
+K_THREAD_STACK_DEFINE(uart_thread_stack, 1024);   // Thread para UART (executa os comandos)
+// A adc_thread roda filtro, calibração e todos os listeners do adc_chan (display,
+// servo, gráfico, log, taxa); a display_thread formata o texto e envia texto e
+// gráfico. Conferidas pelo cenário app.stack do twister (no máximo 75% de uso).
+K_THREAD_STACK_DEFINE(adc_thread_stack, 1536);     // Thread para ADC
+K_THREAD_STACK_DEFINE(display_thread_stack, 1536); // Thread para display
 static struct k_thread uart_thread_data;
 static struct k_thread adc_thread_data;  
 static struct k_thread display_thread_data;
-static k_tid_t blink_tid;
 static k_tid_t uart_tid;
 static k_tid_t adc_tid; 
 static k_tid_t display_tid;
 
 // Definição de prioridades:
-#define BLINK_PRIORITY 6
 #define UART_PRIORITY 5
 #define ADC_PRIORITY 3
 #define DISPLAY_PRIORITY 8
 
 // Semáforos para sincronização entre threads:
-K_SEM_DEFINE(adc_update_sem, 0, 1);       // Semáforo para atualizar ADC
-K_SEM_DEFINE(display_update_sem, 0, 1);   // Semáforo para atualizar display
-K_SEM_DEFINE(blink_control_sem, 0, 1);    // Semáforo para controlar piscar
-
-// Timer para ADC:
-K_TIMER_DEFINE(adc_timer, NULL, NULL);
+K_MUTEX_DEFINE(display_mutex);            // Exclusão mútua no desenho do display
 
 // Verifica disponibilidade do ADC na Device Tree:
+#if !DT_NODE_HAS_PROP(ADC_USER_NODE, io_channels)
+#error "zephyr,user node must list the ADC channels in io-channels"
+#endif
 #if !DT_NODE_HAS_STATUS(ADC_NODE, okay)
 #error "ADC devicetree node is disabled"
 #endif
 
-static int16_t adc_sample_buffer[1];   // Buffer para guardar resultado da conversão ADC.
-
-static uint16_t text_display_buffer[TEXT_BUFFER_SIZE]; // Buffer estático para o display
-
-// Configuração do ADC:
-static const struct adc_channel_cfg channel_cfg = {
-    .gain = ADC_GAIN,
-    .reference = ADC_REFERENCE,
-    .acquisition_time = ADC_ACQUISITION_TIME,
-    .channel_id = ADC_CHANNEL_ID,
-    .differential = 0,
-#ifdef CONFIG_ADC_CONFIGURABLE_INPUTS
-    .input_positive = ADC_CHANNEL_ID,
-#endif
-};
-
-// Configuração da leitura do ADC:
-static const struct adc_sequence adc_seq = {
-    .channels = BIT(ADC_CHANNEL_ID),
-    .buffer = adc_sample_buffer,
-    .buffer_size = sizeof(adc_sample_buffer),
-    .resolution = ADC_RESOLUTION,
-};
-
-// Variáveis globais para compartilhar dados do ADC entre threads:
-static int32_t current_voltage_mv = 0;
-static uint8_t current_percentage = 0;
-static bool adc_data_ready = false;
-
-// Mutex para proteger acesso aos dados do ADC:
-K_MUTEX_DEFINE(adc_data_mutex);
-
-// Fila de mensagens para comunicação UART:
-#define MSG_SIZE 16
-K_MSGQ_DEFINE(msgq, MSG_SIZE, 10, 4); // 10 mensagens de até 16 caracteres          
-
 const struct device *uart_dev = DEVICE_DT_GET(UART_DEVICE_NODE);  // Obtem o dispositivo da UART - converte nó da Device Tree em ponteiro para o dispositivo.
 
 const struct gpio_dt_spec led0 = GPIO_DT_SPEC_GET(LED0_NODE, gpios); // Device tree diz que o LED está no pino 0
 
-const struct device *display_dev; // O display vai ser inicializado em display_init()
-
-// Estados do LED (inicializam falsos, pois o LED está desligado):
-static bool led_on = false;
-static bool led_blinking = false;
-
-static struct display_capabilities capabilities; // Struct com informações sobre as capacidades do display (largura,altura e formato de pixels)
-
-// Fonte bitmap 8x8 para os caracteres a serem impressos no display:
-static const uint8_t font_8x8[][8] = {
-    {0x3C, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3C}, // 0: O  
-    {0x66, 0x76, 0x7E, 0x7E, 0x6E, 0x66, 0x66, 0x66}, // 1: N 
-    {0x7E, 0x60, 0x60, 0x7C, 0x60, 0x60, 0x60, 0x60}, // 2: F
-    {0x7C, 0x66, 0x66, 0x7C, 0x66, 0x66, 0x66, 0x7C}, // 3: B
-    {0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x7E}, // 4: L
-    {0x3C, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x3C}, // 5: I
-    {0x66, 0x6C, 0x78, 0x70, 0x78, 0x6C, 0x66, 0x66}, // 6: K
-    {0x3C, 0x66, 0x60, 0x60, 0x6E, 0x66, 0x66, 0x3C}, // 7: G
-    {0x7E, 0x60, 0x60, 0x7C, 0x60, 0x60, 0x60, 0x7E}, // 8: E
-    {0x7C, 0x66, 0x66, 0x7C, 0x78, 0x6C, 0x66, 0x66}, // 9: R
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 10: Espaço
-    {0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00}, // 11: :
-    {0x00, 0x00, 0x00, 0x7E, 0x00, 0x00, 0x00, 0x00}, // 12: -
-    {0x7E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18}, // 13: T
-    {0x00, 0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00}, // 14: .
-    {0x63, 0x66, 0x0C, 0x18, 0x30, 0x60, 0xC6, 0xC6}, // 15: %
-    {0x7C, 0x66, 0x66, 0x7C, 0x60, 0x60, 0x60, 0x60}, // 16: P
-    {0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3C, 0x18}, // 17: V
-    {0x66, 0x66, 0x66, 0x7E, 0x7E, 0x5A, 0x42, 0x42}, // 18: M
-    {0x7C, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x7C}, // 19: D
-    {0x18, 0x24, 0x42, 0x42, 0x7E, 0x42, 0x42, 0x42}, // 20: A 
-    {0x3C, 0x66, 0x60, 0x60, 0x60, 0x60, 0x66, 0x3C}, // 21: C
-    {0x3C, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3C}, // 22: 0
-    {0x18, 0x38, 0x18, 0x18, 0x18, 0x18, 0x18, 0x7E}, // 23: 1
-    {0x3C, 0x66, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x7E}, // 24: 2
-    {0x3C, 0x66, 0x06, 0x1C, 0x06, 0x66, 0x66, 0x3C}, // 25: 3
-    {0x0C, 0x1C, 0x3C, 0x6C, 0x6C, 0x7E, 0x0C, 0x0C}, // 26: 4
-    {0x7E, 0x60, 0x60, 0x7C, 0x06, 0x06, 0x66, 0x3C}, // 27: 5
-    {0x3C, 0x66, 0x60, 0x7C, 0x66, 0x66, 0x66, 0x3C}, // 28: 6
-    {0x7E, 0x06, 0x06, 0x0C, 0x18, 0x30, 0x30, 0x30}, // 29: 7
-    {0x3C, 0x66, 0x66, 0x3C, 0x66, 0x66, 0x66, 0x3C}, // 30: 8
-    {0x3C, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x66, 0x3C}  // 31: 9
+// Texto exibido para cada estado do LED (o estado atual fica no led_chan):
+static const char *const led_mode_names[] = {
+    [LED_MODE_OFF]   = "OFF",
+    [LED_MODE_ON]    = "ON",
+    [LED_MODE_BLINK] = "BLINKING",
+    [LED_MODE_DIM]   = "DIM",
 };
 
-// Mapeamento dos caracteres:
-static int get_char_index(char c) {
-    switch(c) {
-        case 'O': return 0;
-        case 'N': return 1;
-        case 'F': return 2;
-        case 'B': return 3;
-        case 'L': return 4;
-        case 'I': return 5;
-        case 'K': return 6;
-        case 'G': return 7;
-        case 'E': return 8;
-        case 'R': return 9;
-        case ' ': return 10;
-        case ':': return 11;
-        case '-': return 12;
-        case 'T': return 13;
-        case '.': return 14;
-        case '%': return 15;
-        case 'P': return 16;
-        case 'V': return 17;  
-        case 'M': return 18;
-        case 'D': return 19;  
-        case 'A': return 20;  
-        case 'C': return 21;  
-        case '0': return 22;
-        case '1': return 23;
-        case '2': return 24;
-        case '3': return 25;
-        case '4': return 26;
-        case '5': return 27;
-        case '6': return 28;
-        case '7': return 29;
-        case '8': return 30;
-        case '9': return 31;
-        default: return 10; // Retorna espaço para caracteres não encontrados
-    }
-}
-
-// Renderiza caracteres no buffer de display:
-void draw_char(uint16_t *buffer, int buf_width, int x, int y, char c, uint16_t color) {
-    int16_t char_idx = get_char_index(c);
-    
-    for (uint8_t row = 0; row < 8; row++) {
-        uint8_t char_row = font_8x8[char_idx][row];
-        for (uint8_t col = 0; col < 8; col++) {
-            if (char_row & (0x80 >> col)) {
-                uint16_t pixel_x = x + col;
-                uint16_t pixel_y = y + row;
-                if (pixel_x < buf_width && pixel_y < 64) {
-                    buffer[pixel_y * buf_width + pixel_x] = color;
-                }
-            }
-        }
-    }
-}
+static uint32_t led_blink_ms = LED_BLINK_INTERVAL_MS; // Intervalo do pisca (comando "blink")
 
-// Escreve strings no buffer do display:
-void draw_text(uint16_t *buffer, int buf_width, int x, int y, const char *text, uint16_t color) {
-    uint16_t char_x = x;
-    
-    while (*text) {
-        draw_char(buffer, buf_width, char_x, y, *text, color);
-        char_x += 9;
-        if (char_x + 8 > buf_width) {
-            y += 9;
-            char_x = x;
-        }
-        text++;
-    }
-}
+// Estado do LED pedido pelos comandos. Durante um alarme o LED pisca pela thread
+// de alarmes, e os comandos só atualizam este estado, aplicado quando o alarme termina:
+static struct led_state_msg led_user = { .mode = LED_MODE_OFF };
+static bool led_alarm_active;
+K_MUTEX_DEFINE(led_mutex);               // led_user x thread de alarmes
 
-// Inicializa e configura o display:
-void display_init(void)
+// Chamada pela thread de transmissão do display quando o quadro chega aos pixels
+// (cookie = instante do fim do bloco do ADC exibido):
+static void display_frame_done(uint32_t cookie)
 {
-    int ret = 0;
-    display_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
-    
-    if (!device_is_ready(display_dev)) {
-        printk("Display is not ready.\n");
-        return;
-    }
-    
-    display_get_capabilities(display_dev, &capabilities);
-    
-    ret = display_blanking_off(display_dev);
-    if (ret != 0) {
-        printk("Failed to disable display blanking\n");
-    }
+    latency_record(LAT_END_TO_END, k_cycle_get_32() - cookie);
 }
 
 // Atualiza o display com status do LED e dados do ADC:
 void display_update_status(const char *status)
 {
-    if (!display_dev || !device_is_ready(display_dev)) {
-        return;
-    }
-    
-    uint16_t *text_buffer = text_display_buffer;
-    memset(text_buffer, 0, sizeof(text_display_buffer));
+    static uint32_t last_seq_shown = UINT32_MAX;
+    uint32_t start = k_cycle_get_32();
+    uint32_t end;
+    bool new_value;
+    char adc_text[32];
+    struct adc_snapshot snap;
 
     // Cores para diferentes status:
     uint16_t led_color;
@@ -230,353 +100,450 @@ void display_update_status(const char *status)
         led_color = 0xFFFF; // Branco
     }
     
-    // Desenha status do LED:
-    draw_text(text_buffer, TEXT_BUFFER_WIDTH, 5, 5, "LED: ", 0xFFFF);
-    draw_text(text_buffer, TEXT_BUFFER_WIDTH, 50, 5, status, led_color);
+    k_mutex_lock(&display_mutex, K_FOREVER);
     
-    // Desenha dados do ADC:
-    if (k_mutex_lock(&adc_data_mutex, K_MSEC(10)) == 0) {
-        if (adc_data_ready) {
-            char adc_text[32];
-            
-            draw_text(text_buffer, TEXT_BUFFER_WIDTH, 5, 20, "VOLTAGE:", 0xFFFF);
-            snprintf(adc_text, sizeof(adc_text), "%d", current_voltage_mv);
-            draw_text(text_buffer, TEXT_BUFFER_WIDTH, 90, 20, adc_text, 0x07FF);
-            
-            draw_text(text_buffer, TEXT_BUFFER_WIDTH, 5, 35, "PERCENT:", 0xFFFF);
-            snprintf(adc_text, sizeof(adc_text), "%d %%", current_percentage);
-            draw_text(text_buffer, TEXT_BUFFER_WIDTH, 90, 35, adc_text, 0x07FF);
-        } else {
-            draw_text(text_buffer, TEXT_BUFFER_WIDTH, 5, 20, "ADC: READING...", 0xFFFF);
+    // Status do LED:
+    text_field_set(FIELD_LED_LABEL, "LED: ", 0xFFFF);
+    text_field_set(FIELD_LED_VALUE, status, led_color);
+    
+    // Dados do ADC:
+    adc_snapshot_get(&snap);
+    if (snap.ready) {
+        text_field_set(FIELD_VOLT_LABEL, "VOLTAGE:", 0xFFFF);
+        snprintf(adc_text, sizeof(adc_text), "%d", snap.voltage_mv);
+        text_field_set(FIELD_VOLT_VALUE, adc_text, 0x07FF);
+        
+        text_field_set(FIELD_PCT_LABEL, "PERCENT:", 0xFFFF);
+        snprintf(adc_text, sizeof(adc_text), "%d %%", snap.percentage);
+        text_field_set(FIELD_PCT_VALUE, adc_text, 0x07FF);
+        
+        // Uma linha por canal extra:
+        for (int ch = 1; ch < ADC_NUM_CHANNELS; ch++) {
+            snprintf(adc_text, sizeof(adc_text), "CH%u: %d mV", adc_acq_channel(ch)->channel_id,
+                     snap.channels[ch].voltage_mv);
+            text_field_set(FIELD_CH1 + ch - 1, adc_text, 0x07FF);
         }
-        k_mutex_unlock(&adc_data_mutex);
+    } else {
+        text_field_set(FIELD_VOLT_LABEL, "ADC: READING...", 0xFFFF);
+        text_field_set(FIELD_VOLT_VALUE, "", 0x07FF);
+        text_field_set(FIELD_PCT_LABEL, "", 0xFFFF);
+        text_field_set(FIELD_PCT_VALUE, "", 0x07FF);
     }
     
-    struct display_buffer_descriptor desc = {
-        .buf_size = TEXT_BUFFER_WIDTH * TEXT_BUFFER_HEIGHT * 2,
-        .width = TEXT_BUFFER_WIDTH,
-        .height = TEXT_BUFFER_HEIGHT,
-        .pitch = TEXT_BUFFER_WIDTH
-    };
+    // Latências só para quadros com um valor novo do ADC:
+    new_value = snap.ready && snap.seq != last_seq_shown;
     
-    display_write(display_dev, 10, 10, &desc, text_buffer);
-}
-
-// Função para obter dados do ADC:
-void get_adc_data(int32_t *voltage_mv, uint8_t *percentage)
-{
-    if (k_mutex_lock(&adc_data_mutex, K_MSEC(100)) == 0) {
-        if (adc_data_ready) {
-            *voltage_mv = current_voltage_mv;
-            *percentage = current_percentage;
-        } else {
-            *voltage_mv = 0;
-            *percentage = 0;
-        }
-        k_mutex_unlock(&adc_data_mutex);
+    // Colunas novas do gráfico de histórico (entram no mesmo quadro):
+    chart_flush();
+    
+    // Enfileira apenas os campos que mudaram desde o último quadro; a transmissão
+    // segue em paralelo e display_frame_done marca a chegada aos pixels:
+    text_display_flush(new_value ? display_frame_done : NULL, snap.timestamp);
+    end = k_cycle_get_32();
+    k_mutex_unlock(&display_mutex);
+    
+    if (new_value) {
+        last_seq_shown = snap.seq;
+        latency_record(LAT_DISPLAY_WAKE, start - snap.published);
+        latency_record(LAT_DISPLAY_DRAW, end - start);
     }
 }
 
-// Callback do timer ADC para sinalizar leitura:
-void adc_timer_callback(struct k_timer *timer)
-{
-    k_sem_give(&adc_update_sem);
-}
-
 // Thread para leitura do ADC:
 static void adc_thread(void *a, void *b, void *c)
 {
-    const struct device *adc_dev;
+    struct adc_block *blk;
+    static int16_t raw_samples[ADC_BLOCK_SAMPLES];
+    static int16_t filtered_samples[ADC_BLOCK_SAMPLES];
+    struct adc_snapshot snap = { 0 };
+    struct adc_snapshot *msg;
     int32_t ret;
     int32_t voltage_mv;
+    int32_t raw_sum;
+    uint32_t wake;
     
-    adc_dev = DEVICE_DT_GET(ADC_NODE);
-    if (!device_is_ready(adc_dev)) {
-        printk("ADC device not ready\n");
+    // Configura os canais listados no devicetree:
+    ret = adc_acq_init();
+    if (ret < 0) {
+        printk("Error setting up ADC channels: %d\n", ret);
         return;
     }
     
-    ret = adc_channel_setup(adc_dev, &channel_cfg);
+#if defined(CONFIG_ADC_EMUL)
+    // Sem potenciômetro no emulador: fixa as entradas no meio da escala
+    for (uint8_t ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+        adc_emul_const_value_set(adc_acq_channel(ch)->dev, adc_acq_channel(ch)->channel_id,
+                                 BENCH_EMUL_INPUT_MV);
+    }
+#endif
+    
+    // Inicia a aquisição contínua no buffer circular:
+    ret = adc_acq_start();
     if (ret < 0) {
-        printk("Error setting up ADC channel: %d\n", ret);
+        printk("Error starting ADC stream: %d\n", ret);
         return;
     }
     
-    // Inicia o timer para leitura periódica do ADC:
-    k_timer_init(&adc_timer, adc_timer_callback, NULL);
-    k_timer_start(&adc_timer, K_MSEC(500), K_MSEC(500));
-    
     while (1) {
-        // Aguarda semáforo:
-        k_sem_take(&adc_update_sem, K_FOREVER);
-        
-        // Realiza leitura do ADC:
-        ret = adc_read(adc_dev, &adc_seq);
-        if (ret < 0) {
-            printk("ADC read error: %d\n", ret);
+        // Aguarda o próximo bloco de amostras (até dois blocos na taxa atual, para
+        // a verificação de erros não acordar a thread à toa em taxas baixas):
+        blk = adc_acq_block_get(K_MSEC(ADC_BLOCK_TIMEOUT_MS +
+                                       2 * ADC_BLOCK_SAMPLES * MSEC_PER_SEC / adc_acq_rate_get()));
+        if (blk == NULL) {
             continue;
         }
+        wake = k_cycle_get_32();
+        latency_record(LAT_ADC_WAKE, wake - blk->timestamp);
         
-        // Converte valor bruto para tensão em mV:
-        voltage_mv = adc_sample_buffer[0];
-        ret = adc_raw_to_millivolts(adc_ref_internal(adc_dev), ADC_GAIN, ADC_RESOLUTION, &voltage_mv);
+        // Cada canal é separado, filtrado e decimado (o bloco bruto segue intacto para a telemetria):
+        for (uint8_t ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+            struct adc_channel_value *v = &snap.channels[ch];
+            
+            adc_acq_block_channel(blk, ch, raw_samples);
+            filter_process(ch, raw_samples, filtered_samples, blk->count);
+            ret = adc_acq_to_mv(ch, filtered_samples, blk->count, &v->voltage_mv);
+            if (ret < 0) {
+                break;
+            }
+            
+            // Faixa das amostras brutas no bloco (ruído pico a pico) e média para a calibração:
+            v->min_raw = raw_samples[0];
+            v->max_raw = raw_samples[0];
+            raw_sum = raw_samples[0];
+            for (int i = 1; i < blk->count; i++) {
+                v->min_raw = MIN(v->min_raw, raw_samples[i]);
+                v->max_raw = MAX(v->max_raw, raw_samples[i]);
+                raw_sum += raw_samples[i];
+            }
+            v->raw_q4 = (raw_sum << CALIB_FRAC_BITS) / blk->count;
+            
+            // Extremos desde o início da aquisição:
+            if (!snap.ready || v->voltage_mv < v->min_mv) {
+                v->min_mv = v->voltage_mv;
+            }
+            if (!snap.ready || v->voltage_mv > v->max_mv) {
+                v->max_mv = v->voltage_mv;
+            }
+        }
         
         if (ret < 0) {
             printk("Error converting to mV: %d\n", ret);
             continue;
         }
         
-        // Calcula porcentagem da tensão em relação aos 3,3V:
-        uint8_t percentage = (voltage_mv * 100) / 3300;
-        if (percentage > 100) percentage = 100;
-        if (percentage < 0) percentage = 0;
+        // O primeiro canal (potenciômetro) também alimenta tensão e porcentagem:
+        voltage_mv = snap.channels[0].voltage_mv;
         
-        // Atualiza variáveis globais:
-        if (k_mutex_lock(&adc_data_mutex, K_MSEC(100)) == 0) {
-            current_voltage_mv = voltage_mv;
-            current_percentage = percentage;
-            adc_data_ready = true;
-            k_mutex_unlock(&adc_data_mutex);
-        }
+        // Envia o bloco bruto pela telemetria binária (se o modo stream estiver ativo):
+        telemetry_submit_block(blk, voltage_mv);
+        
+        // Publica o novo valor sem bloquear (leitores nunca seguram a thread do ADC):
+        snap.voltage_mv = voltage_mv;
+        snap.percentage = calib_percent(voltage_mv); // Fundo de escala da calibração, limitada a 0..100
+        snap.ready = true;
+        snap.seq = blk->seq;
+        snap.timestamp = blk->timestamp;
+        snap.interval_us = blk->interval_us;
+        snap.published = k_cycle_get_32();
+        adc_snapshot_publish(&snap);
+        latency_record(LAT_ADC_PROCESS, snap.published - wake);
         
-        // Sinaliza que display deve ser atualizado:
-        k_sem_give(&display_update_sem);
+        // Entrega o valor aos observadores do adc_chan (display, servo...). O snap
+        // local guarda os extremos entre blocos e é copiado para a mensagem do canal
+        // (uma cópia curta com o canal reservado, em vez de processar o bloco inteiro
+        // com ele reservado); os listeners leem a mensagem sem outra cópia:
+        msg = bus_claim(&adc_chan);
+        if (msg != NULL) {
+            *msg = snap;
+            bus_publish_claimed(&adc_chan);
+        }
     }
 }
 
 // Thread dedicada para atualização do display:
 static void display_thread(void *a, void *b, void *c)
 {
+    struct led_state_msg led;
+    
     while (1) {
-        // Aguarda sinal para atualizar display:
-        k_sem_take(&display_update_sem, K_FOREVER);
+        // Aguarda o próximo quadro (eventos agrupados e taxa limitada):
+        display_sched_wait();
         
         // Atualiza display com status atual:
-        if (led_blinking) {
-            display_update_status("BLINKING");
-        } else if (led_on) {
-            display_update_status("ON");
-        } else {
-            display_update_status("OFF");
-        }
+        zbus_chan_read(&led_chan, &led, K_FOREVER);
+        display_update_status(led_mode_names[led.mode]);
     }
 }
 
+// Aciona o LED e publica o novo estado (o display observa o led_chan). Com led_mutex:
+static int led_apply(const struct led_state_msg *led)
+{
+    int ret = 0;
+    
+    switch (led->mode) {
+        case LED_MODE_ON:
+            led_out_set(true);
+            break;
+        case LED_MODE_BLINK:
+            ret = led_out_blink(led->interval_ms); // Pisca pelo timer, sem acordar threads
+            break;
+        case LED_MODE_DIM:
+            ret = led_out_dim(led->dim_percent);
+            break;
+        default:
+            led_out_set(false);
+            break;
+    }
+    if (ret == 0) {
+        bus_publish(&led_chan, led);
+    }
+    return ret;
+}
+
+// Estado pedido por um comando: vale na hora, ou quando o alarme em andamento terminar
+static int led_request(const struct led_state_msg *led)
+{
+    int ret = 0;
+    
+    k_mutex_lock(&led_mutex, K_FOREVER);
+    if (led_alarm_active) {
+        uart_io_printf("LED held by an active alarm, applied when it clears\n");
+    } else {
+        ret = led_apply(led);
+    }
+    if (ret == 0) {
+        led_user = *led;
+    }
+    k_mutex_unlock(&led_mutex);
+    
+    return ret;
+}
+
+// Chamada pela thread de alarmes: pisca enquanto houver alarme e depois volta ao
+// último estado pedido pelos comandos (mesmo os recebidos durante o alarme)
+void led_alarm(bool active)
+{
+    struct led_state_msg blink = { .mode = LED_MODE_BLINK, .interval_ms = led_blink_ms };
+    int ret;
+    
+    k_mutex_lock(&led_mutex, K_FOREVER);
+    led_alarm_active = active;
+    ret = led_apply(active ? &blink : &led_user);
+    if (ret < 0) {
+        // LED aceso fixo: durante o alarme ainda sinaliza, e não fica apagado em silêncio
+        uart_io_printf("LED %s failed (%d), leaving it on\n", active ? "alarm blink" : "restore", ret);
+        led_apply(&(struct led_state_msg){ .mode = LED_MODE_ON });
+    }
+    k_mutex_unlock(&led_mutex);
+}
+
 // Função de controle do LED:
 void led_control(int command)
 {
     const char *status_text;
+    struct led_state_msg led = { .mode = LED_MODE_OFF };
+    int ret;
     
     switch(command) {
         case 0: // Desliga o LED
-            led_blinking = false;
-            led_on = false;
-            gpio_pin_set_dt(&led0, 0);
             status_text = "OFF";
-            printk("LED OFF\n");
+            uart_io_printf("LED OFF\n");
             break;
         case 1: // Liga o LED
-            led_blinking = false;
-            led_on = true;
-            gpio_pin_set_dt(&led0, 1);
+            led.mode = LED_MODE_ON;
             status_text = "ON";
-            printk("LED ON\n");
+            uart_io_printf("LED ON\n");
             break;
         case 2: // Pisca o LED
-            led_blinking = true;
-            led_on = false;
+            led.mode = LED_MODE_BLINK;
+            led.interval_ms = led_blink_ms;
             status_text = "BLINKING";
-            printk("LED BLINKING\n");
-            k_sem_give(&blink_control_sem); // Sinaliza para a thread de piscar começar.
+            uart_io_printf("LED BLINKING\n");
             break;
         default:
-            led_blinking = false;
-            led_on = false;
-            gpio_pin_set_dt(&led0, 0);
             status_text = "ERROR";
-            printk("Invalid command! Use: 0=OFF, 1=ON, 2=BLINK\n");
+            uart_io_printf("Invalid command! Use: 0=OFF, 1=ON, 2=BLINK\n");
             break;
     }
     
-    // Sinaliza atualização do display:
-    k_sem_give(&display_update_sem);
-}
-
-// Funções de informação do sistema:
-static void show_thread_info(void)
-{
-    printk("\n=== THREAD INFORMATION ===\n");
-    printk("%-20s %-10s\n", "Thread Name", "Priority");
-    printk("------------------------------------------------------------\n");
-    
-    printk("%-20s %-10d\n", "main", 0);
-    printk("%-20s %-10d\n", "blink_thread", BLINK_PRIORITY);
-    printk("%-20s %-10d\n", "uart_thread", UART_PRIORITY);
-    printk("%-20s %-10d\n", "adc_thread", ADC_PRIORITY);
-    printk("%-20s %-10d\n", "display_thread", DISPLAY_PRIORITY);
-    
-    printk("\nSemaphores:\n");
-    printk("- adc_update_sem: Controls ADC reading\n");
-    printk("- display_update_sem: Controls display updates\n");
-    printk("- blink_control_sem: Controls LED blinking\n");
-    printk("=========================\n\n");
-}
-
-// Função para mostrar utilização da heap:
-static void show_heap_info(void)
-{
-    struct sys_memory_stats stats;
-    sys_heap_runtime_stats_get(&app_heap, &stats);
-
-    printk("\n=== HEAP INFORMATION ===\n");
-    printk("Heap Size:       %u bytes\n", APP_HEAP_SIZE);
-    printk("Allocated:       %zu bytes\n", APP_HEAP_SIZE - stats.free_bytes);
-    printk("Free:            %zu bytes\n", stats.free_bytes);
-    printk("========================\n\n");
+    ret = led_request(&led);
+    if (ret < 0) {
+        uart_io_printf("LED %s failed: %d\n", led_mode_names[led.mode], ret);
+    }
 }
 
 // Função para mostrar algumas informações de runtime do programa:
-static void show_runtime_info(void)
+static int show_runtime_info(int argc, char *argv[])
 {
-    printk("\n=== RUNTIME INFORMATION ===\n");
-    printk("System Uptime: %lld ms\n", k_uptime_get());
-    printk("System Tick Rate: %d Hz\n", CONFIG_SYS_CLOCK_TICKS_PER_SEC);
-    
-    printk("\nThread Status:\n");
-    printk("- blink_thread: %s\n", led_blinking ? "Active (blinking)" : "Inactive");
-    printk("- uart_thread:  Active (waiting for commands)\n");
-    printk("- adc_thread:   Active (timer-driven)\n");
-    printk("- display_thread: Active (event-driven)\n");
-    printk("===========================\n\n");
+    uint32_t load = thread_stats_cpu_load();
+    
+    uart_io_printf("\n=== RUNTIME INFORMATION ===\n");
+    uart_io_printf("System Uptime: %lld ms\n", k_uptime_get());
+    uart_io_printf("System Tick Rate: %d Hz\n", CONFIG_SYS_CLOCK_TICKS_PER_SEC);
+    uart_io_printf("CPU Load: %u.%u%% (last %u ms)\n", load / 10, load % 10, THREAD_STATS_WINDOW_MS);
+    uart_io_printf("Use 'top' for per-thread CPU and stack usage\n");
+    uart_io_printf("===========================\n\n");
+    
+    return 0;
 }
 
 // Função para mostrar configurações de real time do programa:
-static void show_realtime_info(void)
+static int show_realtime_info(int argc, char *argv[])
 {
-    printk("\n=== REAL-TIME INFORMATION ===\n");
-    printk("Thread Priorities (lower number = higher priority):\n");
-    printk("- main thread:     0\n");
-    printk("- blink_thread:    %d\n", BLINK_PRIORITY);
-    printk("- uart_thread:     %d\n", UART_PRIORITY);
-    printk("- adc_thread:      %d\n", ADC_PRIORITY);
-    printk("- display_thread:  %d\n", DISPLAY_PRIORITY);
-    
-    printk("\nSynchronization Mechanisms:\n");
-    printk("- Semaphores: Event-driven execution\n");
-    printk("- Timer: Periodic ADC reading\n");
-    printk("- Mutex: Thread-safe data access\n");
-    printk("- Message Queue: UART communication\n");
-    printk("=============================\n\n");
+    uart_io_printf("\n=== REAL-TIME INFORMATION ===\n");
+    uart_io_printf("Thread Priorities (lower number = higher priority):\n");
+    uart_io_printf("- main thread:     0\n");
+    uart_io_printf("- uart_thread:     %d\n", UART_PRIORITY);
+    uart_io_printf("- adc_thread:      %d\n", ADC_PRIORITY);
+    uart_io_printf("- display_thread:  %d\n", DISPLAY_PRIORITY);
+    uart_io_printf("- display_tx:      %d\n", DISPLAY_TX_PRIORITY);
+    uart_io_printf("- alarm:           %d\n", ALARM_PRIORITY);
+    
+    uart_io_printf("\nSynchronization Mechanisms:\n");
+    uart_io_printf("- Semaphores: Event-driven execution\n");
+    uart_io_printf("- Display scheduler: coalesced, rate-limited frames with ADC deadband\n");
+    uart_io_printf("- ADC stream: %u Hz scans of %d channel(s) into %d x %d scan ring ('rate')\n",
+                   adc_acq_rate_get(), ADC_NUM_CHANNELS, ADC_RING_BLOCKS, ADC_BLOCK_SAMPLES);
+    uart_io_printf("- Seqlock: Lock-free ADC snapshot\n");
+    uart_io_printf("- zbus: adc/led/cmd channels, zero-copy listeners ('bus' for counters)\n");
+    uart_io_printf("- Ring buffers: UART RX/TX between ISR and threads\n");
+    uart_io_printf("=============================\n\n");
+    
+    return 0;
 }
 
-// Mostra menu de comandos:
-static void show_help(void)
+// Mostra status atuais do sistema:
+static int show_current_status(int argc, char *argv[])
 {
-    printk("\n=== COMMANDS ===\n");
-    printk("LED Control:\n");
-    printk("  0 - Turn LED OFF\n");
-    printk("  1 - Turn LED ON\n");
-    printk("  2 - Start LED BLINKING\n");
-    printk("\nSystem Information:\n");
-    printk("  info     - Show thread information\n");
-    printk("  heap     - Show heap information\n");
-    printk("  runtime  - Show runtime information\n");
-    printk("  realtime - Show real-time information\n");
-    printk("  status   - Show current system status\n");
-    printk("  help     - Show this help menu\n");
-    printk("==========================\n\n");
+    struct adc_snapshot snap;
+    struct adc_acq_stats acq;
+    struct uart_io_stats uart;
+    struct led_state_msg led;
+    adc_snapshot_get(&snap);
+    adc_acq_stats_get(&acq);
+    zbus_chan_read(&led_chan, &led, K_FOREVER);
+    
+    uart_io_printf("\n=== CURRENT STATUS ===\n");
+    uart_io_printf("LED State: %s\n", led_mode_names[led.mode]);
+    if (led.mode == LED_MODE_BLINK) {
+        uart_io_printf("Blink Interval: %u ms\n", led.interval_ms);
+    }
+    uart_io_printf("ADC Voltage: %d mV\n", snap.ready ? snap.voltage_mv : 0);
+    uart_io_printf("ADC Percentage: %d%%\n", snap.ready ? snap.percentage : 0);
+    uart_io_printf("System Uptime: %lld ms\n", k_uptime_get());
+    uart_io_printf("Data Ready: %s\n", snap.ready ? "YES" : "NO");
+    if (snap.ready) {
+        uart_io_printf("Sample: block %u, %u us ago\n", snap.seq,
+                       k_cyc_to_us_floor32(k_cycle_get_32() - snap.timestamp));
+    }
+    uart_io_stats_get(&uart);
+    uart_io_printf("UART RX Overruns: %u bytes, TX Dropped: %u bytes\n",
+                   uart.rx_overruns, uart.tx_dropped);
+    uart_io_printf("ADC Blocks: %u (restarts: %u, errors: %u)\n", acq.blocks, acq.restarts, acq.errors);
+    for (int ch = 0; snap.ready && ch < ADC_NUM_CHANNELS; ch++) {
+        const struct adc_channel_value *v = &snap.channels[ch];
+        
+        uart_io_printf("ADC CH%u: %d mV (min %d, max %d), noise %d LSB p-p\n",
+                       adc_acq_channel(ch)->channel_id, v->voltage_mv, v->min_mv, v->max_mv,
+                       v->max_raw - v->min_raw);
+    }
+    uart_io_printf("======================\n\n");
+    
+    return 0;
 }
 
-// Mostra status atuais do sistema:
-static void show_current_status(void)
+// Comandos de controle do LED ("0", "1" e "2"):
+static int cmd_led(int argc, char *argv[])
 {
-    int32_t voltage_mv;
-    uint8_t percentage;
-    get_adc_data(&voltage_mv, &percentage);
-    
-    printk("\n=== CURRENT STATUS ===\n");
-    printk("LED State: %s\n", led_blinking ? "BLINKING" : (led_on ? "ON" : "OFF"));
-    printk("ADC Voltage: %d mV\n", voltage_mv);
-    printk("ADC Percentage: %d%%\n", percentage);
-    printk("System Uptime: %lld ms\n", k_uptime_get());
-    printk("Data Ready: %s\n", adc_data_ready ? "YES" : "NO");
-    printk("======================\n\n");
+    led_control(argv[0][0] - '0');
+    return 0;
 }
 
-// Callback da UART:
-static void uart_cb(const struct device *dev, void *user_data)
+// Comando "dim <1-100>": brilho do LED por PWM
+static int cmd_dim(int argc, char *argv[])
 {
-    static char rx_buf[MSG_SIZE];
-    static int rx_buf_pos = 0;
-    uint8_t c;
+    uint32_t percent;
+    int ret;
     
-    if (!uart_irq_update(uart_dev)) {
-        return;
+    if (cmd_parse_u32(argv[1], 1, 100, &percent) < 0) {
+        return -EINVAL;
     }
     
-    if (!uart_irq_rx_ready(uart_dev)) {
-        return;
+    if (!led_out_can_dim()) {
+        uart_io_printf("LED pin has no PWM (define a pwm-led0 alias)\n");
+        return 0;
     }
     
-    while (uart_fifo_read(uart_dev, &c, 1) == 1) {
-        if ((c == '\r' || c == '\n') && rx_buf_pos > 0) {
-            rx_buf[rx_buf_pos] = '\0';
-            
-            printk("Received command: %s\n", rx_buf);
-            
-            if (strlen(rx_buf) == 1 && rx_buf[0] >= '0' && rx_buf[0] <= '2') {
-                int led_command = rx_buf[0] - '0';
-                led_control(led_command);
-            }
-            else if (strcmp(rx_buf, "info") == 0) {
-                show_thread_info();
-            } else if (strcmp(rx_buf, "heap") == 0) {
-                show_heap_info();
-            } else if (strcmp(rx_buf, "runtime") == 0) {
-                show_runtime_info();
-            } else if (strcmp(rx_buf, "realtime") == 0) {
-                show_realtime_info();
-            } else if (strcmp(rx_buf, "help") == 0) {
-                show_help();
-            } else if (strcmp(rx_buf, "status") == 0) {
-                show_current_status();
-            } else {
-                printk("Unknown command: %s\n", rx_buf);
-                printk("Type 'help' for available commands.\n");
-            }
-            
-            rx_buf_pos = 0;
-        } else if (rx_buf_pos < (sizeof(rx_buf) - 1)) {
-            rx_buf[rx_buf_pos++] = c;
-        }
+    ret = led_request(&(struct led_state_msg){ .mode = LED_MODE_DIM, .dim_percent = percent });
+    if (ret < 0) {
+        return ret;
     }
+    
+    uart_io_printf("LED DIM %u%%\n", percent);
+    
+    return 0;
 }
 
-// Thread para processar mensagens da UART:
-static void uart_thread(void *a, void *b, void *c)
+// Comando "blink <ms>": intervalo do pisca, reprogramado na hora se o LED estiver piscando
+static int cmd_blink(int argc, char *argv[])
 {
-    char rx_data[MSG_SIZE];
+    struct led_state_msg led;
+    uint32_t ms;
+    int ret;
     
-    while (1) {
-        k_msgq_get(&msgq, &rx_data, K_FOREVER);
-        //printk("Processing queued command: %s\n", rx_data);
+    if (cmd_parse_u32(argv[1], LED_BLINK_MIN_MS, LED_BLINK_MAX_MS, &ms) < 0) {
+        return -EINVAL;
+    }
+    // led_user só muda na uart_thread, que é quem executa este comando. O
+    // intervalo só é guardado se o LED aceitou (o erro sai pelo dispatcher):
+    led = led_user;
+    if (led.mode == LED_MODE_BLINK) {
+        led.interval_ms = ms;
+        ret = led_request(&led);
+        if (ret < 0) {
+            return ret;
+        }
     }
+    led_blink_ms = ms;
+    
+    uart_io_printf("LED blink interval %u ms\n", ms);
+    
+    return 0;
 }
 
-// Thread que pisca LED:
-static void blink_thread(void *a, void *b, void *c)
+APP_CMD_DEFINE(led_off, "0", cmd_led, NULL, 0, 0, "Turn LED OFF");
+APP_CMD_DEFINE(led_on, "1", cmd_led, NULL, 0, 0, "Turn LED ON");
+APP_CMD_DEFINE(led_blink, "2", cmd_led, NULL, 0, 0, "Start LED BLINKING");
+APP_CMD_DEFINE(dim, "dim", cmd_dim, "<1-100>", 1, 1, "Dim the LED (PWM)");
+APP_CMD_DEFINE(blink, "blink", cmd_blink, "<ms>", 1, 1, "Set the LED blink interval");
+APP_CMD_DEFINE(runtime, "runtime", show_runtime_info, NULL, 0, 0, "Show runtime information");
+APP_CMD_DEFINE(realtime, "realtime", show_realtime_info, NULL, 0, 0, "Show real-time information");
+APP_CMD_DEFINE(status, "status", show_current_status, NULL, 0, 0, "Show current system status");
+
+// Thread para montar linhas e executar comandos da UART:
+static void uart_thread(void *a, void *b, void *c)
 {
-    static bool blink_state = false;
+    static char line[CMD_LINE_MAX];
+    int line_pos = 0;
+    uint8_t chunk[16];
+    uint32_t len;
     
     while (1) {
-        if (led_blinking) {
-            blink_state = !blink_state;
-            gpio_pin_set_dt(&led0, blink_state ? 1 : 0);
-            k_sem_take(&blink_control_sem, K_MSEC(LED_BLINK_INTERVAL_MS));  // Bloqueia até timeout ou comando
-        } else {
-            gpio_pin_set_dt(&led0, led_on ? 1 : 0);
-            // Aguarda semáforo para iniciar a piscar:
-            k_sem_take(&blink_control_sem, K_FOREVER);
+        len = uart_io_read(chunk, sizeof(chunk), K_FOREVER);
+        
+        for (uint32_t i = 0; i < len; i++) {
+            uint8_t ch = chunk[i];
+            
+            if (ch == '\r' || ch == '\n') {
+                if (line_pos > 0) {
+                    line[line_pos] = '\0';
+                    uart_io_printf("Received command: %s\n", line);
+                    cmd_dispatch(line);
+                    line_pos = 0;
+                }
+            } else if (line_pos < (int)(sizeof(line) - 1)) {
+                line[line_pos++] = ch;
+            }
         }
     }
 }
@@ -591,41 +558,66 @@ int main(void)
     printk("  1 - Turn LED ON\n");
     printk("  2 - Start LED BLINKING\n");
     printk("System Commands:\n");
-    printk("  info, heap, runtime, realtime, help, status\n");
+    printk("  Type 'help' for the full list\n");
     printk("Enter command: ");
     
-    // Inicializa o heap de aplicação antes de utilizá-lo:
-    sys_heap_init(&app_heap, app_heap_mem, APP_HEAP_SIZE);
-    
     // Inicializa o display:
     display_init();
     
     // Verifica se os periféricos estão prontos:
-    if (!device_is_ready(led0.port)) {
-        printk("ERROR: LED device not ready\n");
-        return -1;
-    }
-    
     if (!device_is_ready(uart_dev)) {
         printk("ERROR: UART device not ready\n");
         return -1;
     }
     
-    ret = gpio_pin_configure_dt(&led0, GPIO_OUTPUT_INACTIVE);
+    ret = led_out_init();
     if (ret < 0) {
         printk("ERROR: Cannot configure LED (%d)\n", ret);
         return ret;
     }
     
-    // Configura callbacks da UART
-    uart_irq_callback_user_data_set(uart_dev, uart_cb, NULL);
-    uart_irq_rx_enable(uart_dev);
+    // O servo é opcional (nó pwm-servo no devicetree):
+    ret = servo_init();
+    if (ret < 0 && ret != -ENODEV) {
+        printk("ERROR: Cannot configure servo (%d)\n", ret);
+    }
+    
+    // Monta a tabela de comandos da UART:
+    cmd_init();
+    
+    // Inicia a medição de uso de CPU por thread (comando "top"):
+    thread_stats_init();
     
-    // Cria thread para piscar LED
-    blink_tid = k_thread_create(&blink_thread_data, blink_thread_stack, 
-                               K_THREAD_STACK_SIZEOF(blink_thread_stack),
-                               blink_thread, NULL, NULL, NULL, BLINK_PRIORITY, 0, K_NO_WAIT);
-    k_thread_name_set(blink_tid, "blink_thread");
+    // Monta a tabela de conversão do ADC com a calibração salva (comando "cal"):
+    ret = calib_init();
+    if (ret < 0) {
+        printk("Calibration not persistent (%d)\n", ret);
+    }
+    
+    // Alarmes de limite (comando "alarm"): GPIO de saída e thread de eventos
+    ret = alarm_init();
+    if (ret < 0) {
+        printk("ERROR: Cannot configure alarm output (%d)\n", ret);
+    }
+    
+    // Modo de economia (comando "power"): o sistema começa ativo
+    ret = power_init();
+    if (ret < 0) {
+        printk("ERROR: Cannot configure power button (%d)\n", ret);
+    }
+    
+    // Abre o log de dados na flash (comandos "log"):
+    ret = datalog_init();
+    if (ret < 0) {
+        printk("Data log disabled (%d)\n", ret);
+    }
+    
+    // Configura a UART por interrupção (RX e TX bufferizados)
+    ret = uart_io_init(uart_dev);
+    if (ret < 0) {
+        printk("ERROR: Cannot configure UART (%d)\n", ret);
+        return ret;
+    }
     
     // Cria thread para processar mensagens UART
     uart_tid = k_thread_create(&uart_thread_data, uart_thread_stack, 
@@ -633,6 +625,11 @@ int main(void)
                               uart_thread, NULL, NULL, NULL, UART_PRIORITY, 0, K_NO_WAIT);
     k_thread_name_set(uart_tid, "uart_thread");
     
+#if defined(CONFIG_APP_FILTER_CHECK_AT_BOOT)
+    // Ordem dos coeficientes do FIR, antes de a adc_thread usar o filtro (CI no twister):
+    filter_check();
+#endif
+    
     // Cria thread para leitura do ADC
     adc_tid = k_thread_create(&adc_thread_data, adc_thread_stack, 
                              K_THREAD_STACK_SIZEOF(adc_thread_stack),
@@ -649,11 +646,41 @@ int main(void)
     display_update_status("OFF");
     
     // Sinaliza primeira atualização do display:
-    k_sem_give(&display_update_sem);
+    display_sched_request();
     
-    while (1) {
-        k_msleep(1000); 
+#if defined(CONFIG_APP_BENCH_AT_BOOT)
+    // Aguarda o primeiro bloco do ADC e roda os benchmarks (CI no twister):
+    k_msleep(ADC_BLOCK_TIMEOUT_MS);
+    bench_run(BENCH_ITERATIONS);
+#endif
+    
+#if defined(CONFIG_APP_LOG_CHECK_AT_BOOT)
+    // Deixa o ADC emulado gerar valores e confere o que foi gravado na flash (CI no twister):
+    k_msleep(DATALOG_CHECK_DELAY_MS);
+    datalog_check(BENCH_EMUL_INPUT_MV, DATALOG_CHECK_TOL_MV);
+#endif
+    
+#if defined(CONFIG_APP_ALARM_CHECK_AT_BOOT)
+    // Limite abaixo da entrada fixa do ADC emulado: o alarme HIGH deve disparar (CI no twister)
+    alarm_set(0, 0, BENCH_EMUL_INPUT_MV / 2, ALARM_HYST_MV, ALARM_DEBOUNCE);
+    k_msleep(ALARM_CHECK_DELAY_MS);
+#endif
+    
+#if defined(CONFIG_APP_STACK_CHECK_AT_BOOT)
+    // Filtro de maior quadro de pilha, taxa automática e gráfico com média: todos os
+    // listeners do adc_chan trabalhando antes de medir o pico das pilhas (CI no twister)
+    {
+        static char lines[][CMD_LINE_MAX] = { "filter median 31", "rate auto", "chart 2" };
+
+        for (size_t i = 0; i < ARRAY_SIZE(lines); i++) {
+            cmd_dispatch(lines[i]);
+        }
     }
+    k_msleep(STACK_CHECK_DELAY_MS);
+    thread_stats_stack_check();
+#endif
     
+    // Daqui em diante tudo é dirigido por eventos: a main termina em vez de
+    // acordar periodicamente.
     return 0;
 }
\ No newline at end of file
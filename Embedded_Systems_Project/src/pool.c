@@ -0,0 +1,22 @@
+#include "pool.h"
+#include "uart_io.h"
+#include "cmd.h"
+
+// Comando "heap": ocupação atual e máxima de cada pool registrado.
+static int cmd_heap(int argc, char *argv[])
+{
+    uart_io_printf("\n=== MEMORY POOLS ===\n");
+    uart_io_printf("%-12s %6s %6s %6s %6s %6s\n", "Pool", "Size", "Blocks", "Used", "Peak", "Free");
+
+    STRUCT_SECTION_FOREACH(app_pool, pool) {
+        uart_io_printf("%-12s %6u %6u %6u %6u %6u\n", pool->name,
+                       (uint32_t)pool->slab->info.block_size, pool->slab->info.num_blocks,
+                       k_mem_slab_num_used_get(pool->slab), k_mem_slab_max_used_get(pool->slab),
+                       k_mem_slab_num_free_get(pool->slab));
+    }
+    uart_io_printf("====================\n\n");
+
+    return 0;
+}
+
+APP_CMD_DEFINE(heap, "heap", cmd_heap, NULL, 0, 0, "Show memory pool usage");
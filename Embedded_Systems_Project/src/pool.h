@@ -0,0 +1,23 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "config.h"
+#include <zephyr/sys/iterable_sections.h>
+
+// Pool de blocos de tamanho fixo (k_mem_slab) registrado em tempo de link
+// (seção iterável "app_pool"), para o comando "heap" listar todos:
+struct app_pool {
+    const char *name;
+    struct k_mem_slab *slab;
+};
+
+// Define o slab _id com _count blocos de _block_size bytes (múltiplo de 4).
+// Alocação e liberação são O(1), sem fragmentação, e podem ocorrer em interrupções.
+#define APP_POOL_DEFINE(_id, _name, _block_size, _count)          \
+    K_MEM_SLAB_DEFINE(_id, _block_size, _count, 4);               \
+    STRUCT_SECTION_ITERABLE(app_pool, app_pool_##_id) = {         \
+        .name = _name,                                            \
+        .slab = &_id,                                             \
+    }
+
+#endif /* POOL_H */
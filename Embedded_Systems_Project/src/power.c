@@ -0,0 +1,146 @@
+#include "power.h"
+#include "adc_acq.h"
+#include "thread_stats.h"
+#include "uart_io.h"
+#include "cmd.h"
+
+#if defined(CONFIG_PM)
+#include <zephyr/pm/pm.h>
+#include <zephyr/pm/policy.h>
+
+#define POWER_BUTTON_NODE DT_ALIAS(sw0)
+
+static const struct gpio_dt_spec power_button = GPIO_DT_SPEC_GET_OR(POWER_BUTTON_NODE, gpios, {0});
+static struct gpio_callback power_button_cb_data;
+
+static atomic_t power_save = ATOMIC_INIT(0);
+static uint32_t power_stop_exits;       // Saídas do STOP desde o último "power save"
+static uint32_t power_save_since_ms;
+
+// Chamado pela thread idle, com as interrupções travadas, ao sair de um estado do PM:
+static void power_state_exit(enum pm_state state)
+{
+    if (state == PM_STATE_SUSPEND_TO_IDLE) {
+        power_stop_exits++;
+    }
+}
+
+static struct pm_notifier power_notifier = {
+    .state_exit = power_state_exit,
+};
+
+// Botão USER (interrupção EXTI, que também acorda do STOP): volta ao modo ativo
+static void power_button_cb(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+{
+    power_save_set(false);
+}
+
+int power_init(void)
+{
+    int ret;
+
+    // O STOP fica travado até "power save":
+    pm_policy_state_lock_get(PM_STATE_SUSPEND_TO_IDLE, PM_ALL_SUBSTATES);
+    pm_notifier_register(&power_notifier);
+
+    if (power_button.port == NULL) {
+        return 0;
+    }
+    if (!gpio_is_ready_dt(&power_button)) {
+        return -ENODEV;
+    }
+    ret = gpio_pin_configure_dt(&power_button, GPIO_INPUT);
+    if (ret < 0) {
+        return ret;
+    }
+    ret = gpio_pin_interrupt_configure_dt(&power_button, GPIO_INT_EDGE_TO_ACTIVE);
+    if (ret < 0) {
+        return ret;
+    }
+    gpio_init_callback(&power_button_cb_data, power_button_cb, BIT(power_button.pin));
+
+    return gpio_add_callback(power_button.port, &power_button_cb_data);
+}
+
+int power_save_set(bool enable)
+{
+    if (enable) {
+        // Sem o botão não haveria como voltar a receber comandos
+        if (power_button.port == NULL) {
+            return -ENODEV;
+        }
+        if (atomic_cas(&power_save, 0, 1)) {
+            power_stop_exits = 0;
+            power_save_since_ms = k_uptime_get_32();
+            pm_policy_state_lock_put(PM_STATE_SUSPEND_TO_IDLE, PM_ALL_SUBSTATES);
+        }
+    } else if (atomic_cas(&power_save, 1, 0)) {
+        pm_policy_state_lock_get(PM_STATE_SUSPEND_TO_IDLE, PM_ALL_SUBSTATES);
+    }
+
+    return 0;
+}
+#else
+int power_init(void)
+{
+    return 0;
+}
+
+int power_save_set(bool enable)
+{
+    return enable ? -ENOTSUP : 0;
+}
+#endif
+
+static void power_print(void)
+{
+    uint32_t idle_permille;
+    uint32_t idle_entries;
+
+    thread_stats_idle(&idle_permille, &idle_entries);
+
+    uart_io_printf("\n=== POWER ===\n");
+#if defined(CONFIG_PM)
+    if (atomic_get(&power_save)) {
+        uint32_t elapsed_ms = k_uptime_get_32() - power_save_since_ms;
+
+        uart_io_printf("Mode: save (STOP allowed, USER button returns to active)\n");
+        uart_io_printf("STOP: %u wakeup(s) in %u ms (%u/s)\n", power_stop_exits, elapsed_ms,
+                       elapsed_ms ? (uint32_t)((uint64_t)power_stop_exits * MSEC_PER_SEC / elapsed_ms) : 0);
+    } else {
+        uart_io_printf("Mode: active (STOP held off, idle in WFI)\n");
+    }
+#else
+    uart_io_printf("Mode: active (no CONFIG_PM, idle in WFI)\n");
+#endif
+    uart_io_printf("Idle: %u.%u%% of the last %u ms\n", idle_permille / 10, idle_permille % 10,
+                   THREAD_STATS_WINDOW_MS);
+    uart_io_printf("Thread wakeups: %u/s\n", idle_entries * MSEC_PER_SEC / THREAD_STATS_WINDOW_MS);
+    uart_io_printf("ADC scans: %u/s (timer interrupt only, one thread wakeup per %u scans)\n",
+                   adc_acq_rate_get(), ADC_BLOCK_SAMPLES);
+    uart_io_printf("=============\n\n");
+}
+
+// Comando "power [save|active]": mostra o tempo ocioso e os despertares, ou troca o modo
+static int cmd_power(int argc, char *argv[])
+{
+    int ret = 0;
+
+    if (argc == 2 && strcmp(argv[1], "save") == 0) {
+        ret = power_save_set(true);
+    } else if (argc == 2 && strcmp(argv[1], "active") == 0) {
+        ret = power_save_set(false);
+    } else if (argc == 2) {
+        return -EINVAL;
+    }
+    if (ret < 0) {
+        return ret;
+    }
+
+    power_print();
+
+    return 0;
+}
+
+APP_CMD_DEFINE(power, "power", cmd_power, "[save|active]", 0, 1,
+               "Show idle time and wakeups, or allow STOP between ADC scans");
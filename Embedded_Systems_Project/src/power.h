@@ -0,0 +1,23 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include "config.h"
+
+// Modo de economia (comando "power"). Nenhuma thread acorda por tempo: todas
+// esperam eventos (bloco do ADC, UART, zbus), e cada varredura do ADC é só uma
+// interrupção do timer do kernel (tickless). Entre uma interrupção e outra a
+// thread idle dorme em WFI.
+//
+// Com CONFIG_PM (DISC1), "power save" libera o estado STOP (suspend-to-idle no
+// devicetree): o kernel só o usa quando a próxima interrupção de timer está a
+// mais de min-residency-us e acorda exit-latency-us antes dela, então as
+// varreduras continuam no instante programado. A USART não recebe em STOP:
+// o botão USER (alias sw0) volta ao modo ativo.
+
+// Configura o botão e segura o STOP (o sistema começa no modo ativo):
+int power_init(void);
+
+// Libera (true) ou segura (false) o STOP; -ENOTSUP sem CONFIG_PM:
+int power_save_set(bool enable);
+
+#endif /* POWER_H */
@@ -0,0 +1,238 @@
+#include "pwm_out.h"
+#include "uart_io.h"
+#include "cmd.h"
+#include "bus.h"
+#include <zephyr/drivers/pwm.h>
+
+#define PWM_LED_NODE DT_ALIAS(pwm_led0)
+#define SERVO_NODE   DT_COMPAT_GET_ANY_STATUS_OKAY(pwm_servo)
+
+// LED por PWM: brilho e piscar ficam no hardware do timer. Um pisca mais longo
+// que o contador do timer (ou que os 32 bits de ns da API de PWM) é feito por um
+// k_timer alternando o ciclo ativo entre 0 e 100%.
+#if DT_NODE_EXISTS(PWM_LED_NODE)
+static const struct pwm_dt_spec led_pwm = PWM_DT_SPEC_GET(PWM_LED_NODE);
+static bool led_pwm_on;
+
+static void led_pwm_blink_expiry(struct k_timer *timer)
+{
+    led_pwm_on = !led_pwm_on;
+    pwm_set_dt(&led_pwm, led_pwm.period, led_pwm_on ? led_pwm.period : 0);
+}
+
+K_TIMER_DEFINE(led_pwm_blink_timer, led_pwm_blink_expiry, NULL);
+
+int led_out_init(void)
+{
+    if (!pwm_is_ready_dt(&led_pwm)) {
+        return -ENODEV;
+    }
+    return pwm_set_dt(&led_pwm, led_pwm.period, 0);
+}
+
+void led_out_set(bool on)
+{
+    k_timer_stop(&led_pwm_blink_timer);
+    pwm_set_dt(&led_pwm, led_pwm.period, on ? led_pwm.period : 0);
+}
+
+// Pisca pelo próprio timer: período de dois intervalos com 50% de ciclo ativo.
+int led_out_blink(uint32_t interval_ms)
+{
+    uint64_t period_ns = 2ULL * interval_ms * NSEC_PER_MSEC; // Até 20 s: não cabe em 32 bits
+    int ret;
+
+    k_timer_stop(&led_pwm_blink_timer);
+    if (period_ns <= UINT32_MAX &&
+        pwm_set_dt(&led_pwm, (uint32_t)period_ns, (uint32_t)(period_ns / 2)) == 0) {
+        return 0;
+    }
+
+    // O driver recusa períodos acima do contador (ex.: ~25 ms num timer de 16 bits
+    // com prescaler 63): o k_timer alterna o LED a cada intervalo
+    led_pwm_on = false;
+    ret = pwm_set_dt(&led_pwm, led_pwm.period, 0);
+    if (ret < 0) {
+        return ret;
+    }
+    k_timer_start(&led_pwm_blink_timer, K_MSEC(interval_ms), K_MSEC(interval_ms));
+    return 0;
+}
+
+int led_out_dim(uint8_t percent)
+{
+    k_timer_stop(&led_pwm_blink_timer);
+    return pwm_set_dt(&led_pwm, led_pwm.period, (uint32_t)((uint64_t)led_pwm.period * percent / 100));
+}
+
+bool led_out_can_dim(void)
+{
+    return true;
+}
+#else
+// Sem PWM no pino do LED: o k_timer alterna o GPIO no contexto da interrupção do timer.
+static void led_blink_expiry(struct k_timer *timer)
+{
+    gpio_pin_toggle_dt(&led0);
+}
+
+K_TIMER_DEFINE(led_blink_timer, led_blink_expiry, NULL);
+
+int led_out_init(void)
+{
+    if (!gpio_is_ready_dt(&led0)) {
+        return -ENODEV;
+    }
+    return gpio_pin_configure_dt(&led0, GPIO_OUTPUT_INACTIVE);
+}
+
+void led_out_set(bool on)
+{
+    k_timer_stop(&led_blink_timer);
+    gpio_pin_set_dt(&led0, on ? 1 : 0);
+}
+
+int led_out_blink(uint32_t interval_ms)
+{
+    k_timer_start(&led_blink_timer, K_MSEC(interval_ms), K_MSEC(interval_ms));
+    return 0;
+}
+
+int led_out_dim(uint8_t percent)
+{
+    return -ENOTSUP;
+}
+
+bool led_out_can_dim(void)
+{
+    return false;
+}
+#endif
+
+// Servo: pulso entre min-pulse (0 grau) e max-pulse (SERVO_MAX_ANGLE) a cada period.
+#if DT_NODE_EXISTS(SERVO_NODE)
+static const struct pwm_dt_spec servo_pwm = PWM_DT_SPEC_GET(SERVO_NODE);
+static const uint32_t servo_min_ns = DT_PROP(SERVO_NODE, min_pulse);
+static const uint32_t servo_max_ns = DT_PROP(SERVO_NODE, max_pulse);
+static const uint32_t servo_period_ns = DT_PROP(SERVO_NODE, period);
+
+static atomic_t servo_follow = ATOMIC_INIT(0);
+static uint32_t servo_mdeg;          // Ângulo atual em milésimos de grau
+static uint32_t servo_pulse_ns;      // Último pulso programado
+static uint32_t servo_last_ms;       // Instante da última atualização do modo seguidor
+K_MUTEX_DEFINE(servo_mutex);
+
+static int servo_write(uint32_t mdeg)
+{
+    uint32_t pulse = servo_min_ns + (uint32_t)((uint64_t)(servo_max_ns - servo_min_ns) * mdeg /
+                                               (SERVO_MAX_ANGLE * 1000));
+    int ret = 0;
+
+    servo_mdeg = mdeg;
+    if (pulse != servo_pulse_ns) {
+        ret = pwm_set_dt(&servo_pwm, servo_period_ns, pulse);
+        servo_pulse_ns = pulse;
+    }
+    return ret;
+}
+
+int servo_init(void)
+{
+    if (!pwm_is_ready_dt(&servo_pwm)) {
+        return -ENODEV;
+    }
+    return servo_write(DT_PROP(SERVO_NODE, initial_angle) * 1000);
+}
+
+int servo_set_angle(uint8_t angle)
+{
+    int ret;
+
+    if (angle > SERVO_MAX_ANGLE) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&servo_mutex, K_FOREVER);
+    atomic_set(&servo_follow, 0);
+    ret = servo_write(angle * 1000);
+    k_mutex_unlock(&servo_mutex);
+
+    return ret;
+}
+
+// Modo seguidor: listener do adc_chan, roda na adc_thread a cada bloco publicado.
+// Listener não pode bloquear: com o servo_mutex ocupado pela uart_thread o bloco
+// é pulado, e o próximo compensa (o passo depende do tempo desde a última atualização).
+static void servo_adc_cb(const struct zbus_channel *chan)
+{
+    const struct adc_snapshot *snap = zbus_chan_const_msg(chan);
+    uint32_t now = k_uptime_get_32();
+    uint32_t target = (uint32_t)MIN(snap->percentage, 100) * SERVO_MAX_ANGLE * 10; // mdeg
+    uint32_t max_step;
+
+    bus_observed(chan);
+
+    if (!atomic_get(&servo_follow) || k_mutex_lock(&servo_mutex, K_NO_WAIT) != 0) {
+        return;
+    }
+
+    // O comando pode ter voltado ao modo manual enquanto segurava o mutex:
+    if (!atomic_get(&servo_follow)) {
+        k_mutex_unlock(&servo_mutex);
+        return;
+    }
+
+    // Limita a velocidade: no máximo SERVO_SLEW_DEG_PER_S desde a última atualização
+    max_step = (now - servo_last_ms) * SERVO_SLEW_DEG_PER_S;
+    servo_last_ms = now;
+    if (target > servo_mdeg) {
+        servo_write(servo_mdeg + MIN(target - servo_mdeg, max_step));
+    } else {
+        servo_write(servo_mdeg - MIN(servo_mdeg - target, max_step));
+    }
+
+    k_mutex_unlock(&servo_mutex);
+}
+
+ZBUS_LISTENER_DEFINE(servo_adc_lis, servo_adc_cb);
+ZBUS_CHAN_ADD_OBS(adc_chan, servo_adc_lis, 2);
+
+// Comando "servo [angle|adc]":
+static int cmd_servo(int argc, char *argv[])
+{
+    uint32_t angle;
+
+    if (argc == 1) {
+        uart_io_printf("Servo: %u.%03u deg, pulse %u ns, mode %s\n", servo_mdeg / 1000,
+                       servo_mdeg % 1000, servo_pulse_ns,
+                       atomic_get(&servo_follow) ? "adc" : "manual");
+        return 0;
+    }
+
+    if (strcmp(argv[1], "adc") == 0) {
+        k_mutex_lock(&servo_mutex, K_FOREVER);
+        servo_last_ms = k_uptime_get_32();
+        atomic_set(&servo_follow, 1);
+        k_mutex_unlock(&servo_mutex);
+        uart_io_printf("Servo following ADC (max %u deg/s)\n", SERVO_SLEW_DEG_PER_S);
+        return 0;
+    }
+
+    if (cmd_parse_u32(argv[1], 0, SERVO_MAX_ANGLE, &angle) < 0) {
+        return -EINVAL;
+    }
+    return servo_set_angle(angle);
+}
+
+APP_CMD_DEFINE(servo, "servo", cmd_servo, "[0-180|adc]", 0, 1, "Set servo angle or follow the ADC");
+#else
+int servo_init(void)
+{
+    return -ENODEV;
+}
+
+int servo_set_angle(uint8_t angle)
+{
+    return -ENODEV;
+}
+#endif
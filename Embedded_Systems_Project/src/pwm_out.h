@@ -0,0 +1,22 @@
+#ifndef PWM_OUT_H
+#define PWM_OUT_H
+
+#include "config.h"
+
+// LED: por PWM quando a placa define o alias pwm-led0; senão, pelo GPIO led0
+// com um k_timer alternando o pino. Nenhum dos dois modos acorda threads. O
+// pisca aceita de LED_BLINK_MIN_MS a LED_BLINK_MAX_MS nos dois modos.
+int led_out_init(void);
+void led_out_set(bool on);
+int led_out_blink(uint32_t interval_ms);
+int led_out_dim(uint8_t percent);  // -ENOTSUP sem PWM
+bool led_out_can_dim(void);        // LED em pino de PWM (alias pwm-led0)
+
+// Servo descrito por um nó "pwm-servo" no devicetree (dts/bindings/pwm-servo.yaml):
+int servo_init(void);
+int servo_set_angle(uint8_t angle);
+
+// Modo seguidor ("servo adc"): a porcentagem publicada no adc_chan vira ângulo,
+// limitado a SERVO_SLEW_DEG_PER_S.
+
+#endif /* PWM_OUT_H */
@@ -0,0 +1,182 @@
+#include "telemetry.h"
+#include "uart_io.h"
+#include "cmd.h"
+#include "pool.h"
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+
+// Maior quadro de bloco do ADC após COBS (1 byte extra a cada 254), CRC e delimitador:
+#define TELEMETRY_FRAME_MAX \
+    TELEMETRY_FRAME_SIZE(TELEMETRY_HEADER_SIZE + ADC_BLOCK_SAMPLES * ADC_NUM_CHANNELS * sizeof(int16_t))
+
+// Cada quadro é codificado direto em um bloco do pool e entregue à UART sem cópia:
+APP_POOL_DEFINE(telemetry_frames, "telemetry",
+                ROUND_UP(sizeof(struct uart_buf) + TELEMETRY_FRAME_MAX, 4), TELEMETRY_FRAME_POOL);
+static struct telemetry_stats telemetry_stats;
+static atomic_t telemetry_enabled = ATOMIC_INIT(0);
+static uint32_t telemetry_seq = 0;               // Só a adc_thread acessa
+static atomic_t telemetry_seq_reset = ATOMIC_INIT(0); // "stream on" pede a numeração do zero
+static uint32_t telemetry_last_block = 0;
+
+// Codificador COBS incremental: recebe o pacote em partes (cabeçalho, amostras, CRC)
+// e escreve direto no quadro de saída, sem montar uma cópia bruta do pacote.
+struct cobs_encoder {
+    uint8_t *out;
+    size_t pos;        // Próxima posição livre
+    size_t code_pos;   // Posição do byte de código do grupo atual
+    uint8_t code;      // Distância até o próximo zero
+    uint16_t crc;
+};
+
+static void cobs_begin(struct cobs_encoder *enc, uint8_t *out)
+{
+    enc->out = out;
+    enc->code_pos = 0;
+    enc->pos = 1;
+    enc->code = 1;
+    enc->crc = 0xFFFF;
+}
+
+static void cobs_put(struct cobs_encoder *enc, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] == 0) {
+            enc->out[enc->code_pos] = enc->code;
+            enc->code_pos = enc->pos++;
+            enc->code = 1;
+        } else {
+            enc->out[enc->pos++] = data[i];
+            if (++enc->code == 0xFF) {
+                enc->out[enc->code_pos] = enc->code;
+                enc->code_pos = enc->pos++;
+                enc->code = 1;
+            }
+        }
+    }
+}
+
+// Adiciona dados ao pacote, atualizando o CRC:
+static void frame_put(struct cobs_encoder *enc, const void *data, size_t len)
+{
+    enc->crc = crc16_ccitt(enc->crc, data, len);
+    cobs_put(enc, data, len);
+}
+
+static size_t cobs_end(struct cobs_encoder *enc)
+{
+    uint8_t crc[2];
+
+    sys_put_le16(enc->crc, crc);
+    cobs_put(enc, crc, sizeof(crc));
+
+    enc->out[enc->code_pos] = enc->code;
+    enc->out[enc->pos++] = 0x00; // Delimitador de quadro
+    return enc->pos;
+}
+
+void telemetry_submit_block(const struct adc_block *blk, int32_t voltage_mv)
+{
+    struct cobs_encoder enc;
+    uint8_t header[TELEMETRY_HEADER_SIZE];
+    struct uart_buf *frame;
+
+    if (!atomic_get(&telemetry_enabled)) {
+        return;
+    }
+
+    // O reinício pedido pelo comando é aplicado aqui, entre dois quadros:
+    if (atomic_cas(&telemetry_seq_reset, 1, 0)) {
+        telemetry_seq = 0;
+    }
+
+    if (telemetry_seq > 0 && blk->seq != telemetry_last_block + 1) {
+        telemetry_stats.block_gaps += blk->seq - telemetry_last_block - 1;
+    }
+    telemetry_last_block = blk->seq;
+
+    header[0] = TELEMETRY_TYPE_ADC_BLOCK;
+    header[1] = TELEMETRY_VERSION;
+    sys_put_le16(blk->count, &header[2]);
+    sys_put_le32(telemetry_seq, &header[4]);
+    sys_put_le32(blk->seq, &header[8]);
+    sys_put_le32(blk->timestamp, &header[12]);
+    sys_put_le32(sys_clock_hw_cycles_per_sec(), &header[16]);
+    sys_put_le32((uint32_t)voltage_mv, &header[20]);
+    sys_put_le32(telemetry_stats.dropped, &header[24]);
+    header[28] = blk->channels;
+    header[29] = 0;
+
+    telemetry_seq++;
+
+    // Sem bloco livre, a UART ainda não esvaziou os quadros anteriores:
+    if (k_mem_slab_alloc(&telemetry_frames, (void **)&frame, K_NO_WAIT) < 0) {
+        telemetry_stats.dropped++;
+        return;
+    }
+
+    // As amostras vão direto do buffer de aquisição (o Cortex-M é little-endian):
+    cobs_begin(&enc, frame->data);
+    frame_put(&enc, header, sizeof(header));
+    frame_put(&enc, blk->samples, blk->count * blk->channels * sizeof(int16_t));
+    frame->len = cobs_end(&enc);
+    frame->slab = &telemetry_frames;
+
+    uart_io_send_buf(frame);
+    telemetry_stats.frames++;
+}
+
+void telemetry_stats_get(struct telemetry_stats *stats)
+{
+    *stats = telemetry_stats;
+}
+
+int telemetry_send_packet(struct k_mem_slab *pool, const void *header, size_t header_len,
+                          const void *payload, size_t payload_len, k_timeout_t timeout)
+{
+    struct cobs_encoder enc;
+    struct uart_buf *frame;
+    int ret;
+
+    ret = k_mem_slab_alloc(pool, (void **)&frame, timeout);
+    if (ret < 0) {
+        return ret;
+    }
+
+    cobs_begin(&enc, frame->data);
+    frame_put(&enc, header, header_len);
+    frame_put(&enc, payload, payload_len);
+    frame->len = cobs_end(&enc);
+    frame->slab = pool;
+
+    uart_io_send_buf(frame);
+    return 0;
+}
+
+// Comando "stream on|off|stats":
+static int cmd_stream(int argc, char *argv[])
+{
+    struct adc_acq_stats acq;
+
+    if (strcmp(argv[1], "on") == 0) {
+        atomic_set(&telemetry_seq_reset, 1);
+        atomic_set(&telemetry_enabled, 1);
+    } else if (strcmp(argv[1], "off") == 0) {
+        atomic_set(&telemetry_enabled, 0);
+    } else if (strcmp(argv[1], "stats") == 0) {
+        adc_acq_stats_get(&acq);
+        uart_io_printf("\n=== STREAM STATISTICS ===\n");
+        uart_io_printf("Streaming:      %s\n", atomic_get(&telemetry_enabled) ? "ON" : "OFF");
+        uart_io_printf("Frames sent:    %u\n", telemetry_stats.frames);
+        uart_io_printf("Frames dropped: %u\n", telemetry_stats.dropped);
+        uart_io_printf("Block gaps:     %u\n", telemetry_stats.block_gaps);
+        uart_io_printf("ADC errors:     %u\n", acq.errors);
+        uart_io_printf("=========================\n\n");
+    } else {
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+APP_CMD_DEFINE(stream, "stream", cmd_stream, "<on|off|stats>", 1, 1,
+               "Binary ADC telemetry over UART");
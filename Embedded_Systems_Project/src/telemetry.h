@@ -0,0 +1,54 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "config.h"
+#include "adc_acq.h"
+
+// Formato do pacote de telemetria (little-endian), antes do enquadramento COBS:
+//   u8  type        TELEMETRY_TYPE_ADC_BLOCK
+//   u8  version     TELEMETRY_VERSION
+//   u16 count       varreduras no bloco (amostras por canal)
+//   u32 seq         número do pacote
+//   u32 block_seq   número do bloco de aquisição
+//   u32 timestamp   ciclo de clock da última amostra
+//   u32 cycle_hz    frequência do contador de ciclos
+//   i32 voltage_mv  valor publicado para o bloco (primeiro canal)
+//   u32 dropped     pacotes descartados até agora (buffer de TX cheio)
+//   u8  channels    amostras por varredura (versão 2)
+//   u8  reserved
+//   i16 samples[count * channels]  intercaladas, em ordem crescente de canal do ADC
+//   u16 crc         CRC-16/CCITT (semente 0xFFFF) de todos os campos anteriores
+// Cada pacote codificado em COBS termina com um byte 0x00.
+#define TELEMETRY_TYPE_ADC_BLOCK 0x01
+#define TELEMETRY_VERSION        2
+#define TELEMETRY_HEADER_SIZE    30
+
+// Pacotes do comando "log dump" (mesmo enquadramento COBS + CRC-16):
+//   TELEMETRY_TYPE_LOG_RECORD: u8 type, u32 index, registro do log como está na
+//                              flash (formato em datalog.h)
+//   TELEMETRY_TYPE_LOG_END:    u8 type, u32 records, u32 bytes (fim do dump)
+#define TELEMETRY_TYPE_LOG_RECORD 0x02
+#define TELEMETRY_TYPE_LOG_END    0x03
+
+// Tamanho de um quadro COBS (com delimitador) para um pacote de raw bytes sem o CRC:
+#define TELEMETRY_FRAME_SIZE(raw) ((raw) + 2 + ((raw) + 2) / 254 + 2)
+
+// Estatísticas do modo stream:
+struct telemetry_stats {
+    uint32_t frames;       // Pacotes enfileirados para transmissão
+    uint32_t dropped;      // Pacotes descartados por falta de espaço no TX
+    uint32_t block_gaps;   // Blocos de aquisição que não chegaram à telemetria
+};
+
+// Envia um bloco de amostras se o modo stream estiver ativo (chamada pela thread do ADC):
+void telemetry_submit_block(const struct adc_block *blk, int32_t voltage_mv);
+
+void telemetry_stats_get(struct telemetry_stats *stats);
+
+// Envia um pacote de outro tipo (header começa pelo tipo) usando um pool próprio,
+// com blocos de ao menos sizeof(struct uart_buf) + TELEMETRY_FRAME_SIZE(tamanho).
+// Espera até timeout por um bloco livre, então serve de controle de fluxo.
+int telemetry_send_packet(struct k_mem_slab *pool, const void *header, size_t header_len,
+                          const void *payload, size_t payload_len, k_timeout_t timeout);
+
+#endif /* TELEMETRY_H */
@@ -0,0 +1,547 @@
+#include "text_display.h"
+#include "bench.h"
+
+const struct device *display_dev; // O display vai ser inicializado em display_init()
+
+static struct display_capabilities capabilities; // Struct com informações sobre as capacidades do display (largura,altura e formato de pixels)
+
+// Superfície de texto compactada em 1 bit por pixel (bit 7 = pixel mais à esquerda).
+// A cor vem do campo dono do pixel e só é aplicada ao transmitir:
+static uint8_t text_surface[TEXT_SURFACE_SIZE];
+
+// Trechos RGB565 em buffer duplo: enquanto um é transmitido pelo SPI (DMA), o
+// display_thread expande o próximo. Os livres circulam por strip_free_q:
+static uint16_t text_strips[TEXT_STRIP_COUNT][TEXT_STRIP_PIXELS];
+
+// Trecho pronto para transmissão, em coordenadas da tela (pixels == NULL marca o
+// fim de um quadro):
+struct text_strip_msg {
+    uint16_t *pixels;
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t rows;
+    text_frame_done_t done;
+    uint32_t cookie;
+};
+
+K_MSGQ_DEFINE(strip_free_q, sizeof(uint16_t *), TEXT_STRIP_COUNT, 4);
+K_MSGQ_DEFINE(strip_ready_q, sizeof(struct text_strip_msg), TEXT_STRIP_COUNT + 1, 4);
+
+K_THREAD_STACK_DEFINE(display_tx_stack, 768); // display_write desce até o driver SPI
+static struct k_thread display_tx_data;
+static atomic_t tx_error; // Último erro de display_write, devolvido pelo próximo flush
+
+// Fonte bitmap 8x8 com todos os caracteres ASCII imprimíveis, indexada pelo código
+// do caractere (bit 7 = coluna mais à esquerda):
+#define FONT_FIRST_CHAR 0x20
+#define FONT_LAST_CHAR  0x7E
+#define FONT_HEIGHT     8
+
+static const uint8_t font_8x8[FONT_LAST_CHAR - FONT_FIRST_CHAR + 1][FONT_HEIGHT] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x20: espaço
+    {0x18, 0x18, 0x18, 0x18, 0x18, 0x00, 0x18, 0x00}, // 0x21: !
+    {0x6C, 0x6C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x22: "
+    {0x24, 0x24, 0x7E, 0x24, 0x24, 0x7E, 0x24, 0x24}, // 0x23: #
+    {0x18, 0x3E, 0x60, 0x3C, 0x06, 0x7C, 0x18, 0x00}, // 0x24: $
+    {0x63, 0x66, 0x0C, 0x18, 0x30, 0x60, 0xC6, 0xC6}, // 0x25: %
+    {0x38, 0x6C, 0x38, 0x76, 0x6E, 0x66, 0x3B, 0x00}, // 0x26: &
+    {0x18, 0x18, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x27: '
+    {0x0C, 0x18, 0x30, 0x30, 0x30, 0x30, 0x18, 0x0C}, // 0x28: (
+    {0x30, 0x18, 0x0C, 0x0C, 0x0C, 0x0C, 0x18, 0x30}, // 0x29: )
+    {0x00, 0x66, 0x3C, 0x7E, 0x3C, 0x66, 0x00, 0x00}, // 0x2A: *
+    {0x00, 0x18, 0x18, 0x7E, 0x18, 0x18, 0x00, 0x00}, // 0x2B: +
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x30}, // 0x2C: ,
+    {0x00, 0x00, 0x00, 0x7E, 0x00, 0x00, 0x00, 0x00}, // 0x2D: -
+    {0x00, 0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00}, // 0x2E: .
+    {0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x00}, // 0x2F: /
+    {0x3C, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3C}, // 0x30: 0
+    {0x18, 0x38, 0x18, 0x18, 0x18, 0x18, 0x18, 0x7E}, // 0x31: 1
+    {0x3C, 0x66, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x7E}, // 0x32: 2
+    {0x3C, 0x66, 0x06, 0x1C, 0x06, 0x66, 0x66, 0x3C}, // 0x33: 3
+    {0x0C, 0x1C, 0x3C, 0x6C, 0x6C, 0x7E, 0x0C, 0x0C}, // 0x34: 4
+    {0x7E, 0x60, 0x60, 0x7C, 0x06, 0x06, 0x66, 0x3C}, // 0x35: 5
+    {0x3C, 0x66, 0x60, 0x7C, 0x66, 0x66, 0x66, 0x3C}, // 0x36: 6
+    {0x7E, 0x06, 0x06, 0x0C, 0x18, 0x30, 0x30, 0x30}, // 0x37: 7
+    {0x3C, 0x66, 0x66, 0x3C, 0x66, 0x66, 0x66, 0x3C}, // 0x38: 8
+    {0x3C, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x66, 0x3C}, // 0x39: 9
+    {0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00}, // 0x3A: :
+    {0x00, 0x18, 0x18, 0x00, 0x00, 0x18, 0x18, 0x30}, // 0x3B: ;
+    {0x0C, 0x18, 0x30, 0x60, 0x30, 0x18, 0x0C, 0x00}, // 0x3C: <
+    {0x00, 0x00, 0x7E, 0x00, 0x7E, 0x00, 0x00, 0x00}, // 0x3D: =
+    {0x30, 0x18, 0x0C, 0x06, 0x0C, 0x18, 0x30, 0x00}, // 0x3E: >
+    {0x3C, 0x66, 0x06, 0x0C, 0x18, 0x18, 0x00, 0x18}, // 0x3F: ?
+    {0x3C, 0x66, 0x6E, 0x6E, 0x6E, 0x60, 0x3C, 0x00}, // 0x40: @
+    {0x18, 0x24, 0x42, 0x42, 0x7E, 0x42, 0x42, 0x42}, // 0x41: A
+    {0x7C, 0x66, 0x66, 0x7C, 0x66, 0x66, 0x66, 0x7C}, // 0x42: B
+    {0x3C, 0x66, 0x60, 0x60, 0x60, 0x60, 0x66, 0x3C}, // 0x43: C
+    {0x7C, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x7C}, // 0x44: D
+    {0x7E, 0x60, 0x60, 0x7C, 0x60, 0x60, 0x60, 0x7E}, // 0x45: E
+    {0x7E, 0x60, 0x60, 0x7C, 0x60, 0x60, 0x60, 0x60}, // 0x46: F
+    {0x3C, 0x66, 0x60, 0x60, 0x6E, 0x66, 0x66, 0x3C}, // 0x47: G
+    {0x66, 0x66, 0x66, 0x7E, 0x66, 0x66, 0x66, 0x66}, // 0x48: H
+    {0x3C, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x3C}, // 0x49: I
+    {0x1E, 0x0C, 0x0C, 0x0C, 0x0C, 0x6C, 0x6C, 0x38}, // 0x4A: J
+    {0x66, 0x6C, 0x78, 0x70, 0x78, 0x6C, 0x66, 0x66}, // 0x4B: K
+    {0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x7E}, // 0x4C: L
+    {0x66, 0x66, 0x66, 0x7E, 0x7E, 0x5A, 0x42, 0x42}, // 0x4D: M
+    {0x66, 0x76, 0x7E, 0x7E, 0x6E, 0x66, 0x66, 0x66}, // 0x4E: N
+    {0x3C, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3C}, // 0x4F: O
+    {0x7C, 0x66, 0x66, 0x7C, 0x60, 0x60, 0x60, 0x60}, // 0x50: P
+    {0x3C, 0x66, 0x66, 0x66, 0x66, 0x6E, 0x3C, 0x06}, // 0x51: Q
+    {0x7C, 0x66, 0x66, 0x7C, 0x78, 0x6C, 0x66, 0x66}, // 0x52: R
+    {0x3C, 0x66, 0x60, 0x3C, 0x06, 0x06, 0x66, 0x3C}, // 0x53: S
+    {0x7E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18}, // 0x54: T
+    {0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3C}, // 0x55: U
+    {0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3C, 0x18}, // 0x56: V
+    {0x42, 0x42, 0x42, 0x5A, 0x7E, 0x7E, 0x66, 0x66}, // 0x57: W
+    {0x66, 0x66, 0x3C, 0x18, 0x18, 0x3C, 0x66, 0x66}, // 0x58: X
+    {0x66, 0x66, 0x66, 0x3C, 0x18, 0x18, 0x18, 0x18}, // 0x59: Y
+    {0x7E, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x60, 0x7E}, // 0x5A: Z
+    {0x3C, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x3C}, // 0x5B: [
+    {0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x00}, // 0x5C: barra invertida
+    {0x3C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x3C}, // 0x5D: ]
+    {0x18, 0x3C, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x5E: ^
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF}, // 0x5F: _
+    {0x30, 0x18, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x60: `
+    {0x00, 0x00, 0x3C, 0x06, 0x3E, 0x66, 0x3E, 0x00}, // 0x61: a
+    {0x60, 0x60, 0x7C, 0x66, 0x66, 0x66, 0x7C, 0x00}, // 0x62: b
+    {0x00, 0x00, 0x3C, 0x60, 0x60, 0x60, 0x3C, 0x00}, // 0x63: c
+    {0x06, 0x06, 0x3E, 0x66, 0x66, 0x66, 0x3E, 0x00}, // 0x64: d
+    {0x00, 0x00, 0x3C, 0x66, 0x7E, 0x60, 0x3C, 0x00}, // 0x65: e
+    {0x1C, 0x30, 0x7C, 0x30, 0x30, 0x30, 0x30, 0x00}, // 0x66: f
+    {0x00, 0x3E, 0x66, 0x66, 0x3E, 0x06, 0x3C, 0x00}, // 0x67: g
+    {0x60, 0x60, 0x7C, 0x66, 0x66, 0x66, 0x66, 0x00}, // 0x68: h
+    {0x18, 0x00, 0x38, 0x18, 0x18, 0x18, 0x3C, 0x00}, // 0x69: i
+    {0x06, 0x00, 0x0E, 0x06, 0x06, 0x66, 0x3C, 0x00}, // 0x6A: j
+    {0x60, 0x60, 0x66, 0x6C, 0x78, 0x6C, 0x66, 0x00}, // 0x6B: k
+    {0x38, 0x18, 0x18, 0x18, 0x18, 0x18, 0x3C, 0x00}, // 0x6C: l
+    {0x00, 0x00, 0x6C, 0x7E, 0x5A, 0x5A, 0x42, 0x00}, // 0x6D: m
+    {0x00, 0x00, 0x7C, 0x66, 0x66, 0x66, 0x66, 0x00}, // 0x6E: n
+    {0x00, 0x00, 0x3C, 0x66, 0x66, 0x66, 0x3C, 0x00}, // 0x6F: o
+    {0x00, 0x7C, 0x66, 0x66, 0x7C, 0x60, 0x60, 0x00}, // 0x70: p
+    {0x00, 0x3E, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x00}, // 0x71: q
+    {0x00, 0x00, 0x7C, 0x66, 0x60, 0x60, 0x60, 0x00}, // 0x72: r
+    {0x00, 0x00, 0x3E, 0x60, 0x3C, 0x06, 0x7C, 0x00}, // 0x73: s
+    {0x30, 0x30, 0x7C, 0x30, 0x30, 0x30, 0x1C, 0x00}, // 0x74: t
+    {0x00, 0x00, 0x66, 0x66, 0x66, 0x66, 0x3E, 0x00}, // 0x75: u
+    {0x00, 0x00, 0x66, 0x66, 0x66, 0x3C, 0x18, 0x00}, // 0x76: v
+    {0x00, 0x00, 0x42, 0x5A, 0x5A, 0x7E, 0x24, 0x00}, // 0x77: w
+    {0x00, 0x00, 0x66, 0x3C, 0x18, 0x3C, 0x66, 0x00}, // 0x78: x
+    {0x00, 0x66, 0x66, 0x66, 0x3E, 0x06, 0x3C, 0x00}, // 0x79: y
+    {0x00, 0x00, 0x7E, 0x0C, 0x18, 0x30, 0x7E, 0x00}, // 0x7A: z
+    {0x0E, 0x18, 0x18, 0x70, 0x18, 0x18, 0x0E, 0x00}, // 0x7B: {
+    {0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18}, // 0x7C: |
+    {0x70, 0x18, 0x18, 0x0E, 0x18, 0x18, 0x70, 0x00}, // 0x7D: }
+    {0x00, 0x00, 0x32, 0x4C, 0x00, 0x00, 0x00, 0x00}  // 0x7E: ~
+};
+
+// Caracteres fora da faixa imprimível são desenhados como espaço:
+static inline const uint8_t *font_glyph(char c)
+{
+    uint8_t code = (uint8_t)c;
+
+    if (code < FONT_FIRST_CHAR || code > FONT_LAST_CHAR) {
+        code = ' ';
+    }
+    return font_8x8[code - FONT_FIRST_CHAR];
+}
+
+// Renderiza caracteres na superfície de 1 bpp. Cada linha do glifo é escrita de uma
+// vez como um trecho de 16 bits sobre os dois bytes que ela cobre; o recorte é
+// calculado uma única vez por glifo.
+void draw_char(uint8_t *surface, int buf_width, int x, int y, char c) {
+    const uint8_t *glyph = font_glyph(c);
+    int stride = buf_width / 8;
+    int byte_x = x >> 3;
+    int shift = x & 7;
+    int row_start = 0;
+    int row_end = FONT_HEIGHT;
+    bool hi_ok;
+    bool lo_ok;
+    
+    if (y + FONT_HEIGHT <= 0 || y >= TEXT_BUFFER_HEIGHT) {
+        return;
+    }
+    if (y < 0) {
+        row_start = -y;
+    }
+    if (y + FONT_HEIGHT > TEXT_BUFFER_HEIGHT) {
+        row_end = TEXT_BUFFER_HEIGHT - y;
+    }
+    
+    // Como buf_width é múltiplo de 8, o recorte horizontal é por byte:
+    hi_ok = byte_x >= 0 && byte_x < stride;
+    lo_ok = shift != 0 && byte_x + 1 >= 0 && byte_x + 1 < stride;
+    
+    for (int row = row_start; row < row_end; row++) {
+        uint8_t *line = &surface[(y + row) * stride];
+        uint16_t span = (uint16_t)glyph[row] << (8 - shift);
+        
+        if (hi_ok) {
+            line[byte_x] |= span >> 8;
+        }
+        if (lo_ok) {
+            line[byte_x + 1] |= span & 0xFF;
+        }
+    }
+}
+
+// Escreve strings na superfície de texto:
+void draw_text(uint8_t *surface, int buf_width, int x, int y, const char *text) {
+    uint16_t char_x = x;
+    
+    while (*text) {
+        draw_char(surface, buf_width, char_x, y, *text);
+        char_x += 9;
+        if (char_x + 8 > buf_width) {
+            y += 9;
+            char_x = x;
+        }
+        text++;
+    }
+}
+
+// Transmite os trechos na ordem em que foram renderizados. Com o SPI em DMA, a
+// thread dorme durante a transferência e o display_thread segue expandindo o
+// próximo trecho no outro buffer:
+static void display_tx_thread(void *a, void *b, void *c)
+{
+    struct text_strip_msg msg;
+    struct display_buffer_descriptor desc;
+    int ret;
+    
+    for (;;) {
+        k_msgq_get(&strip_ready_q, &msg, K_FOREVER);
+        
+        if (msg.pixels == NULL) {
+            // Todos os trechos anteriores do quadro já chegaram ao display:
+            msg.done(msg.cookie);
+            continue;
+        }
+        
+        desc.buf_size = msg.w * msg.rows * sizeof(uint16_t);
+        desc.width = msg.w;
+        desc.height = msg.rows;
+        desc.pitch = msg.w;
+        
+        ret = display_write(display_dev, msg.x, msg.y, &desc, msg.pixels);
+        if (ret < 0) {
+            atomic_set(&tx_error, ret);
+        }
+        
+        k_msgq_put(&strip_free_q, &msg.pixels, K_NO_WAIT);
+    }
+}
+
+// Inicializa e configura o display:
+void display_init(void)
+{
+    int ret = 0;
+    display_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+    
+    // Buffers de trecho começam livres (o bench os usa mesmo sem display):
+    for (int i = 0; i < TEXT_STRIP_COUNT; i++) {
+        uint16_t *strip = text_strips[i];
+        k_msgq_put(&strip_free_q, &strip, K_NO_WAIT);
+    }
+    
+    if (!device_is_ready(display_dev)) {
+        printk("Display is not ready.\n");
+        return;
+    }
+    
+    display_get_capabilities(display_dev, &capabilities);
+    
+    ret = display_blanking_off(display_dev);
+    if (ret != 0) {
+        printk("Failed to disable display blanking\n");
+    }
+
+    
+    k_thread_create(&display_tx_data, display_tx_stack, K_THREAD_STACK_SIZEOF(display_tx_stack),
+                    display_tx_thread, NULL, NULL, NULL, DISPLAY_TX_PRIORITY, 0, K_NO_WAIT);
+    k_thread_name_set(&display_tx_data, "display_tx");
+}
+
+
+// Camada de texto retida: guarda o conteúdo de cada campo para transmitir
+// só o que mudou em vez do quadro inteiro.
+struct text_field {
+    uint16_t x;          // Posição na superfície de texto
+    uint16_t y;
+    uint8_t max_chars;   // Largura reservada em caracteres
+    uint16_t color;
+    uint8_t len;         // Caracteres ocupados (define a extensão colorida do campo)
+    uint8_t drawn_len;   // Caracteres presentes na superfície desde o último quadro
+    bool dirty;          // Alterado desde o último quadro
+    char text[TEXT_FIELD_MAX_CHARS + 1];
+};
+
+#define FIELD_CHAR_WIDTH  9  // Largura do glifo (8) + espaçamento (1)
+#define FIELD_HEIGHT      8
+
+static struct text_field text_fields[FIELD_COUNT] = {
+    [FIELD_LED_LABEL]  = { .x = 5,  .y = 5,  .max_chars = 5 },
+    [FIELD_LED_VALUE]  = { .x = 50, .y = 5,  .max_chars = 8 },
+    [FIELD_VOLT_LABEL] = { .x = 5,  .y = 20, .max_chars = 15 }, // Também exibe "ADC: READING..."
+    [FIELD_VOLT_VALUE] = { .x = 90, .y = 20, .max_chars = 7 },
+    [FIELD_PCT_LABEL]  = { .x = 5,  .y = 35, .max_chars = 8 },
+    [FIELD_PCT_VALUE]  = { .x = 90, .y = 35, .max_chars = 7 },
+    [FIELD_CH1]        = { .x = 5,  .y = 50, .max_chars = 15 },
+    [FIELD_CH2]        = { .x = 5,  .y = 65, .max_chars = 15 },
+    [FIELD_CH3]        = { .x = 5,  .y = 80, .max_chars = 15 },
+};
+
+static bool full_redraw = true; // O primeiro quadro limpa a área inteira
+
+// Largura afetada pelo campo: cobre o texto antigo (a apagar) e o novo (a desenhar)
+static inline uint16_t field_width(const struct text_field *f)
+{
+    return MAX(f->len, f->drawn_len) * FIELD_CHAR_WIDTH;
+}
+
+static bool fields_overlap(const struct text_field *a, const struct text_field *b)
+{
+    return a->x < b->x + field_width(b) && b->x < a->x + field_width(a) &&
+           a->y < b->y + FIELD_HEIGHT && b->y < a->y + FIELD_HEIGHT;
+}
+
+void text_field_set(enum text_field_id id, const char *text, uint16_t color)
+{
+    struct text_field *f = &text_fields[id];
+    char clipped[TEXT_FIELD_MAX_CHARS + 1];
+
+    strncpy(clipped, text, f->max_chars);
+    clipped[f->max_chars] = '\0';
+
+    if (f->color != color || strcmp(f->text, clipped) != 0) {
+        strcpy(f->text, clipped);
+        f->len = strlen(clipped);
+        f->color = color;
+        f->dirty = true;
+    }
+}
+
+void text_display_invalidate(void)
+{
+    full_redraw = true;
+}
+
+// Apaga os bits de um retângulo da superfície:
+static void surface_clear_rect(int x, int y, int w, int h)
+{
+    for (int row = y; row < y + h; row++) {
+        uint8_t *bits = &text_surface[row * TEXT_SURFACE_STRIDE];
+        for (int px = x; px < x + w; px++) {
+            bits[px >> 3] &= ~(0x80 >> (px & 7));
+        }
+    }
+}
+
+// Expande os pixels [x0, x1) de uma linha da superfície para RGB565 (pixels apagados
+// ficam com o valor já presente em out, o fundo preto):
+static void expand_span(uint16_t *out, const uint8_t *bits, int x0, int x1, uint16_t color)
+{
+    int px = x0;
+
+    // Pixels iniciais até o próximo limite de byte:
+    for (; px < x1 && (px & 7) != 0; px++, out++) {
+        if (bits[px >> 3] & (0x80 >> (px & 7))) {
+            *out = color;
+        }
+    }
+
+#ifdef CONFIG_CPU_CORTEX_M4
+    // Bytes inteiros: cada par de bits vira uma palavra de 32 bits com dois pixels
+    // (pixel da esquerda na metade baixa, ordem little-endian do Cortex-M4):
+    const uint32_t pair[4] = {
+        0,
+        (uint32_t)color << 16,
+        color,
+        ((uint32_t)color << 16) | color,
+    };
+
+    for (; px + 8 <= x1; px += 8, out += 8) {
+        uint8_t b = bits[px >> 3];
+
+        if (b == 0) {
+            continue;
+        }
+        UNALIGNED_PUT(pair[(b >> 6) & 3], (uint32_t *)&out[0]);
+        UNALIGNED_PUT(pair[(b >> 4) & 3], (uint32_t *)&out[2]);
+        UNALIGNED_PUT(pair[(b >> 2) & 3], (uint32_t *)&out[4]);
+        UNALIGNED_PUT(pair[b & 3], (uint32_t *)&out[6]);
+    }
+#endif
+
+    // Pixels restantes (ou todos, fora do Cortex-M4):
+    for (; px < x1; px++, out++) {
+        if (bits[px >> 3] & (0x80 >> (px & 7))) {
+            *out = color;
+        }
+    }
+}
+
+// Expande linhas da superfície para RGB565 em pixels, usando a cor do campo cujo
+// texto ocupa cada pixel (fora dos campos, fundo preto):
+static void surface_expand(uint16_t *pixels, int x, int y, int w, int rows)
+{
+    for (int r = 0; r < rows; r++) {
+        const uint8_t *bits = &text_surface[(y + r) * TEXT_SURFACE_STRIDE];
+        uint16_t *out = &pixels[r * w];
+
+        memset(out, 0, w * sizeof(uint16_t));
+
+        for (int i = 0; i < FIELD_COUNT; i++) {
+            const struct text_field *f = &text_fields[i];
+            int x0 = MAX(x, f->x);
+            int x1 = MIN(x + w, f->x + f->len * FIELD_CHAR_WIDTH);
+
+            if (y + r < f->y || y + r >= f->y + FIELD_HEIGHT || x0 >= x1) {
+                continue;
+            }
+            expand_span(&out[x0 - x], bits, x0, x1, f->color);
+        }
+    }
+}
+
+uint16_t *display_strip_alloc(void)
+{
+    uint16_t *pixels;
+
+    k_msgq_get(&strip_free_q, &pixels, K_FOREVER);
+    return pixels;
+}
+
+void display_strip_submit(uint16_t *pixels, int x, int y, int w, int h)
+{
+    struct text_strip_msg msg = { .pixels = pixels, .x = x, .y = y, .w = w, .rows = h };
+
+    k_msgq_put(&strip_ready_q, &msg, K_FOREVER);
+}
+
+// Enfileira um retângulo da superfície em trechos de TEXT_CHUNK_ROWS linhas. Só
+// bloqueia quando todos os buffers de trecho ainda estão na fila de transmissão:
+static void surface_write_rect(int x, int y, int w, int h)
+{
+    for (int row = y; row < y + h; row += TEXT_CHUNK_ROWS) {
+        uint16_t *pixels = display_strip_alloc();
+        int rows = MIN(TEXT_CHUNK_ROWS, y + h - row);
+
+        surface_expand(pixels, x, row, w, rows);
+        display_strip_submit(pixels, TEXT_ORIGIN_X + x, TEXT_ORIGIN_Y + row, w, rows);
+    }
+}
+
+// Avisa a thread de transmissão que o quadro terminou (done é chamado por ela):
+static void frame_end(text_frame_done_t done, uint32_t cookie)
+{
+    struct text_strip_msg msg = { .pixels = NULL, .done = done, .cookie = cookie };
+
+    if (done) {
+        k_msgq_put(&strip_ready_q, &msg, K_FOREVER);
+    }
+}
+
+int text_display_flush(text_frame_done_t done, uint32_t cookie)
+{
+    bool changed;
+
+    if (!display_dev || !device_is_ready(display_dev)) {
+        return -ENODEV;
+    }
+
+    if (full_redraw) {
+        memset(text_surface, 0, sizeof(text_surface));
+        for (int i = 0; i < FIELD_COUNT; i++) {
+            draw_text(text_surface, TEXT_BUFFER_WIDTH, text_fields[i].x, text_fields[i].y,
+                      text_fields[i].text);
+            text_fields[i].drawn_len = text_fields[i].len;
+            text_fields[i].dirty = false;
+        }
+        full_redraw = false;
+
+        surface_write_rect(0, 0, TEXT_BUFFER_WIDTH, TEXT_BUFFER_HEIGHT);
+        frame_end(done, cookie);
+        return atomic_clear(&tx_error);
+    }
+
+    // Limpar um campo apaga os que se sobrepõem a ele, então estes também são redesenhados:
+    do {
+        changed = false;
+        for (int i = 0; i < FIELD_COUNT; i++) {
+            for (int j = 0; j < FIELD_COUNT; j++) {
+                if (text_fields[i].dirty && !text_fields[j].dirty &&
+                    fields_overlap(&text_fields[i], &text_fields[j])) {
+                    text_fields[j].dirty = true;
+                    changed = true;
+                }
+            }
+        }
+    } while (changed);
+
+    // Limpa todos os retângulos alterados antes de desenhar, para não apagar texto novo:
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        struct text_field *f = &text_fields[i];
+        if (f->dirty) {
+            surface_clear_rect(f->x, f->y, field_width(f), FIELD_HEIGHT);
+        }
+    }
+
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        struct text_field *f = &text_fields[i];
+        if (f->dirty) {
+            draw_text(text_surface, TEXT_BUFFER_WIDTH, f->x, f->y, f->text);
+        }
+    }
+
+    // Transmite só o retângulo de cada campo alterado:
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        struct text_field *f = &text_fields[i];
+
+        if (!f->dirty) {
+            continue;
+        }
+
+        if (field_width(f) > 0) {
+            surface_write_rect(f->x, f->y, field_width(f), FIELD_HEIGHT);
+        }
+        f->drawn_len = f->len;
+        f->dirty = false;
+    }
+
+    frame_end(done, cookie);
+    return atomic_clear(&tx_error);
+}
+
+// Mede a vazão de draw_text e da expansão para RGB565 (parte do comando "bench").
+// Usa a própria superfície de texto, que é redesenhada por completo em seguida.
+void text_display_bench(uint32_t iterations)
+{
+    static const char sample[] = "VOLTAGE: 3300 %";
+    uint32_t start;
+    uint32_t draw_cycles;
+    uint32_t expand_cycles;
+    uint16_t *strip;
+
+    start = k_cycle_get_32();
+    for (uint32_t i = 0; i < iterations; i++) {
+        draw_text(text_surface, TEXT_BUFFER_WIDTH, 5 + (i & 7), 20, sample);
+    }
+    draw_cycles = k_cycle_get_32() - start;
+
+    // Empresta um buffer de trecho livre (espera o fim de uma transmissão pendente):
+    strip = display_strip_alloc();
+    start = k_cycle_get_32();
+    for (uint32_t i = 0; i < iterations; i++) {
+        surface_expand(strip, 0, 20, TEXT_BUFFER_WIDTH, TEXT_CHUNK_ROWS);
+    }
+    expand_cycles = k_cycle_get_32() - start;
+    k_msgq_put(&strip_free_q, &strip, K_NO_WAIT);
+
+    text_display_invalidate();
+
+    bench_report("draw_text_char", iterations * (sizeof(sample) - 1), draw_cycles);
+    bench_report("expand_line", iterations * TEXT_CHUNK_ROWS, expand_cycles);
+}
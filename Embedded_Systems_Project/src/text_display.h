@@ -0,0 +1,50 @@
+#ifndef TEXT_DISPLAY_H
+#define TEXT_DISPLAY_H
+
+#include "config.h"
+
+// Campos de texto retidos na tela (cada um com posição e largura fixas):
+enum text_field_id {
+    FIELD_LED_LABEL,
+    FIELD_LED_VALUE,
+    FIELD_VOLT_LABEL,
+    FIELD_VOLT_VALUE,
+    FIELD_PCT_LABEL,
+    FIELD_PCT_VALUE,
+    FIELD_CH1,        // Canais extras do ADC (índices 1 a 3 da lista io-channels)
+    FIELD_CH2,
+    FIELD_CH3,
+    FIELD_COUNT
+};
+
+#define TEXT_FIELD_MAX_CHARS 15
+
+// Renderizam em uma superfície de 1 bpp com buf_width pixels por linha (múltiplo de 8):
+void draw_char(uint8_t *surface, int buf_width, int x, int y, char c);
+void draw_text(uint8_t *surface, int buf_width, int x, int y, const char *text);
+
+// Atualiza o texto de um campo. Só marca o campo como alterado se texto ou cor mudarem.
+void text_field_set(enum text_field_id id, const char *text, uint16_t color);
+
+// Chamada pela thread de transmissão quando o último trecho de um quadro chega ao display:
+typedef void (*text_frame_done_t)(uint32_t cookie);
+
+// Redesenha apenas os retângulos dos campos alterados desde o último quadro e os
+// enfileira para transmissão assíncrona. Retorna assim que o último trecho estiver
+// na fila; done (se não for NULL) recebe cookie quando o quadro for escrito.
+// Erros de display_write aparecem no retorno do flush seguinte.
+int text_display_flush(text_frame_done_t done, uint32_t cookie);
+
+// Buffers de trecho (TEXT_STRIP_PIXELS pixels RGB565) para outras camadas da tela.
+// alloc bloqueia até um buffer voltar da transmissão; submit o enfileira para
+// escrita em (x, y), em coordenadas da tela, e o devolve depois de enviado.
+uint16_t *display_strip_alloc(void);
+void display_strip_submit(uint16_t *pixels, int x, int y, int w, int h);
+
+// Força o redesenho completo no próximo quadro:
+void text_display_invalidate(void);
+
+// Mede draw_text e a expansão para RGB565, reportando via bench_report:
+void text_display_bench(uint32_t iterations);
+
+#endif /* TEXT_DISPLAY_H */
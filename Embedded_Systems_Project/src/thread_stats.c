@@ -0,0 +1,241 @@
+#include "thread_stats.h"
+#include "uart_io.h"
+#include "cmd.h"
+
+// Resultado da última janela de cada thread:
+struct thread_entry {
+    const struct k_thread *thread;
+    uint64_t last_cycles;        // Ciclos acumulados no início da janela
+    uint32_t last_switches;      // Trocas de contexto acumuladas no início da janela
+    uint32_t window_cycles;      // Ciclos executados na última janela
+    uint32_t window_switches;    // Vezes em que a thread entrou na CPU na última janela
+    bool alive;
+};
+
+static struct thread_entry thread_entries[THREAD_STATS_MAX_THREADS];
+static uint32_t thread_window_total;   // Ciclos de todas as threads (idle incluída) na última janela
+static uint32_t thread_window_busy;    // Ciclos fora da thread idle na última janela
+static uint64_t thread_last_total;
+static uint64_t thread_last_busy;
+static uint32_t thread_refresh_windows; // Impressão periódica a cada N janelas (0 = desligada)
+static uint32_t thread_refresh_count;
+K_MUTEX_DEFINE(thread_stats_mutex);
+
+static void thread_stats_work_handler(struct k_work *work);
+K_WORK_DELAYABLE_DEFINE(thread_stats_work, thread_stats_work_handler);
+
+static struct thread_entry *thread_entry_get(const struct k_thread *thread)
+{
+    struct thread_entry *free_entry = NULL;
+
+    for (int i = 0; i < THREAD_STATS_MAX_THREADS; i++) {
+        if (thread_entries[i].thread == thread) {
+            return &thread_entries[i];
+        }
+        if (free_entry == NULL && thread_entries[i].thread == NULL) {
+            free_entry = &thread_entries[i];
+        }
+    }
+
+    if (free_entry != NULL) {
+        free_entry->thread = thread;
+    }
+    return free_entry;
+}
+
+static void thread_sample_cb(const struct k_thread *thread, void *user_data)
+{
+    struct thread_entry *e = thread_entry_get(thread);
+    k_thread_runtime_stats_t rt;
+    uint32_t switches;
+
+    if (e == NULL || k_thread_runtime_stats_get((k_tid_t)thread, &rt) < 0) {
+        return;
+    }
+
+    // Cada janela de execução do escalonador corresponde a uma entrada na CPU:
+    switches = thread->base.usage.num_windows;
+
+    e->window_cycles = (uint32_t)(rt.execution_cycles - e->last_cycles);
+    e->window_switches = switches - e->last_switches;
+    e->last_cycles = rt.execution_cycles;
+    e->last_switches = switches;
+    e->alive = true;
+}
+
+static void thread_stats_sample(void)
+{
+    k_thread_runtime_stats_t all;
+
+    k_mutex_lock(&thread_stats_mutex, K_FOREVER);
+
+    // Threads que não aparecerem nesta volta terminaram e liberam a entrada:
+    for (int i = 0; i < THREAD_STATS_MAX_THREADS; i++) {
+        thread_entries[i].alive = false;
+    }
+    k_thread_foreach_unlocked(thread_sample_cb, NULL);
+    for (int i = 0; i < THREAD_STATS_MAX_THREADS; i++) {
+        if (!thread_entries[i].alive) {
+            thread_entries[i].thread = NULL;
+        }
+    }
+
+    k_thread_runtime_stats_all_get(&all);
+    thread_window_total = (uint32_t)(all.execution_cycles - thread_last_total);
+    thread_window_busy = (uint32_t)(all.total_cycles - thread_last_busy);
+    thread_last_total = all.execution_cycles;
+    thread_last_busy = all.total_cycles;
+
+    k_mutex_unlock(&thread_stats_mutex);
+}
+
+// Uso em décimos de %, sobre o total de ciclos da janela:
+static uint32_t thread_permille(uint32_t cycles)
+{
+    return thread_window_total ? (uint32_t)((uint64_t)cycles * 1000 / thread_window_total) : 0;
+}
+
+uint32_t thread_stats_cpu_load(void)
+{
+    uint32_t load;
+
+    k_mutex_lock(&thread_stats_mutex, K_FOREVER);
+    load = thread_permille(thread_window_busy);
+    k_mutex_unlock(&thread_stats_mutex);
+
+    return load;
+}
+
+void thread_stats_idle(uint32_t *idle_permille, uint32_t *entries)
+{
+    *idle_permille = 0;
+    *entries = 0;
+
+    k_mutex_lock(&thread_stats_mutex, K_FOREVER);
+    for (int i = 0; i < THREAD_STATS_MAX_THREADS; i++) {
+        const struct thread_entry *e = &thread_entries[i];
+        const char *name;
+
+        if (e->thread == NULL) {
+            continue;
+        }
+        name = k_thread_name_get((k_tid_t)e->thread);
+        if (name != NULL && strcmp(name, "idle") == 0) {
+            *idle_permille = thread_permille(e->window_cycles);
+            *entries = e->window_switches;
+            break;
+        }
+    }
+    k_mutex_unlock(&thread_stats_mutex);
+}
+
+static void thread_stats_print(void)
+{
+    char state[32];
+
+    k_mutex_lock(&thread_stats_mutex, K_FOREVER);
+
+    uart_io_printf("\n=== TOP (last %u ms, CPU load %u.%u%%) ===\n", THREAD_STATS_WINDOW_MS,
+                   thread_permille(thread_window_busy) / 10, thread_permille(thread_window_busy) % 10);
+    uart_io_printf("%-16s %4s %-10s %6s %6s %11s\n", "Thread", "Prio", "State", "CPU%", "Sw/win",
+                   "Stack used");
+
+    for (int i = 0; i < THREAD_STATS_MAX_THREADS; i++) {
+        struct thread_entry *e = &thread_entries[i];
+        const char *name;
+        size_t unused = 0;
+        size_t size;
+        uint32_t pm;
+
+        if (e->thread == NULL) {
+            continue;
+        }
+
+        name = k_thread_name_get((k_tid_t)e->thread);
+        size = e->thread->stack_info.size;
+        k_thread_stack_space_get(e->thread, &unused);
+        pm = thread_permille(e->window_cycles);
+
+        uart_io_printf("%-16s %4d %-10s %4u.%u %6u %5u/%-5u\n",
+                       (name && name[0]) ? name : "?",
+                       k_thread_priority_get((k_tid_t)e->thread),
+                       k_thread_state_str(e->thread, state, sizeof(state)),
+                       pm / 10, pm % 10, e->window_switches,
+                       (uint32_t)(size - unused), (uint32_t)size);
+    }
+    uart_io_printf("==========================================\n\n");
+
+    k_mutex_unlock(&thread_stats_mutex);
+}
+
+static void thread_stack_check_cb(const struct k_thread *thread, void *user_data)
+{
+    uint32_t *over = user_data;
+    const char *name = k_thread_name_get((k_tid_t)thread);
+    size_t unused = 0;
+    size_t size = thread->stack_info.size;
+    uint32_t used;
+
+    if (k_thread_stack_space_get(thread, &unused) < 0) {
+        return;
+    }
+    used = size - unused;
+    if (used * 100 > size * STACK_CHECK_MAX_PCT) {
+        (*over)++;
+    }
+    printk("STACK,%s,%u,%u\n", (name && name[0]) ? name : "?", used, (uint32_t)size);
+}
+
+int thread_stats_stack_check(void)
+{
+    uint32_t over = 0;
+
+    k_thread_foreach_unlocked(thread_stack_check_cb, &over);
+    printk("STACK_CHECK,%u\n", over);
+
+    return over ? -ENOSPC : 0;
+}
+
+static void thread_stats_work_handler(struct k_work *work)
+{
+    thread_stats_sample();
+
+    if (thread_refresh_windows != 0 && ++thread_refresh_count >= thread_refresh_windows) {
+        thread_refresh_count = 0;
+        thread_stats_print();
+    }
+
+    k_work_schedule(&thread_stats_work, K_MSEC(THREAD_STATS_WINDOW_MS));
+}
+
+void thread_stats_init(void)
+{
+    k_work_schedule(&thread_stats_work, K_MSEC(THREAD_STATS_WINDOW_MS));
+}
+
+// Comando "top [seconds|off]": sem argumento imprime a última janela;
+// com um número, repete a impressão a cada N segundos até "top off".
+static int cmd_top(int argc, char *argv[])
+{
+    uint32_t seconds;
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "off") == 0) {
+            thread_refresh_windows = 0;
+            uart_io_printf("Periodic top disabled\n");
+            return 0;
+        }
+        if (cmd_parse_u32(argv[1], 1, 3600, &seconds) < 0) {
+            return -EINVAL;
+        }
+        thread_refresh_count = 0;
+        thread_refresh_windows = MAX(seconds * MSEC_PER_SEC / THREAD_STATS_WINDOW_MS, 1U);
+    }
+
+    thread_stats_print();
+    return 0;
+}
+
+APP_CMD_DEFINE(top, "top", cmd_top, "[seconds|off]", 0, 1,
+               "Show per-thread CPU, context switches and stack usage");
+APP_CMD_DEFINE(info, "info", cmd_top, "[seconds|off]", 0, 1, "Show thread information (same as top)");
@@ -0,0 +1,21 @@
+#ifndef THREAD_STATS_H
+#define THREAD_STATS_H
+
+#include "config.h"
+
+// Inicia a amostragem periódica (uma janela a cada THREAD_STATS_WINDOW_MS)
+// do uso de CPU e das trocas de contexto de cada thread:
+void thread_stats_init(void);
+
+// Carga de CPU (em décimos de %, sem a thread idle) medida na última janela:
+uint32_t thread_stats_cpu_load(void);
+
+// Thread idle na última janela: tempo (em décimos de %) e quantas vezes ela
+// voltou a rodar, ou seja, quantas vezes alguma thread acordou e depois dormiu:
+void thread_stats_idle(uint32_t *idle_permille, uint32_t *entries);
+
+// Pico de uso da pilha de cada thread (STACK,<thread>,<usado>,<tamanho>) e
+// quantas passaram de STACK_CHECK_MAX_PCT (STACK_CHECK,<n>):
+int thread_stats_stack_check(void);
+
+#endif /* THREAD_STATS_H */
@@ -0,0 +1,169 @@
+#include "uart_io.h"
+#include <stdarg.h>
+
+// Recepção: a interrupção grava no buffer circular e sinaliza o consumidor.
+RING_BUF_DECLARE(uart_rx_ring, UART_RX_RING_SIZE);
+K_SEM_DEFINE(uart_rx_sem, 0, 1);
+
+// Transmissão: as threads enfileiram e a interrupção de TX esvazia o buffer.
+RING_BUF_DECLARE(uart_tx_ring, UART_TX_RING_SIZE);
+static struct k_spinlock uart_tx_lock; // Serializa os produtores do buffer de TX
+
+// Buffers de pools (quadros binários) aguardando a interrupção de TX:
+K_FIFO_DEFINE(uart_tx_fifo);
+static struct uart_buf *uart_tx_buf;   // Buffer em transmissão (só a interrupção acessa)
+static uint16_t uart_tx_buf_pos;
+
+static const struct device *uart_io_dev;
+static struct uart_io_stats uart_stats;
+
+static void uart_io_rx_isr(const struct device *dev)
+{
+    uint8_t *data;
+    uint32_t space;
+    int len;
+    
+    while (1) {
+        space = ring_buf_put_claim(&uart_rx_ring, &data, UART_RX_RING_SIZE);
+        if (space == 0) {
+            // Buffer cheio: descarta o restante da FIFO para liberar a interrupção
+            uint8_t discard;
+            while (uart_fifo_read(dev, &discard, 1) == 1) {
+                uart_stats.rx_overruns++;
+            }
+            break;
+        }
+        
+        len = uart_fifo_read(dev, data, space);
+        ring_buf_put_finish(&uart_rx_ring, len > 0 ? len : 0);
+        if (len < (int)space) {
+            break; // FIFO vazia
+        }
+    }
+    
+    k_sem_give(&uart_rx_sem);
+}
+
+static void uart_io_tx_isr(const struct device *dev)
+{
+    uint8_t *data;
+    uint32_t len;
+    int sent;
+    
+    // Um buffer iniciado vai até o fim; entre buffers, o texto do ring tem a vez:
+    if (uart_tx_buf == NULL) {
+        len = ring_buf_get_claim(&uart_tx_ring, &data, UART_TX_RING_SIZE);
+        if (len > 0) {
+            sent = uart_fifo_fill(dev, data, len);
+            ring_buf_get_finish(&uart_tx_ring, sent > 0 ? sent : 0);
+            return;
+        }
+        
+        uart_tx_buf = k_fifo_get(&uart_tx_fifo, K_NO_WAIT);
+        uart_tx_buf_pos = 0;
+        if (uart_tx_buf == NULL) {
+            uart_irq_tx_disable(dev); // Nada mais a enviar
+            return;
+        }
+    }
+    
+    sent = uart_fifo_fill(dev, &uart_tx_buf->data[uart_tx_buf_pos],
+                          uart_tx_buf->len - uart_tx_buf_pos);
+    uart_tx_buf_pos += sent > 0 ? sent : 0;
+    if (uart_tx_buf_pos == uart_tx_buf->len) {
+        k_mem_slab_free(uart_tx_buf->slab, uart_tx_buf);
+        uart_tx_buf = NULL;
+    }
+}
+
+// Callback da UART (contexto de interrupção): só move bytes entre a FIFO e os buffers.
+static void uart_cb(const struct device *dev, void *user_data)
+{
+    if (!uart_irq_update(dev)) {
+        return;
+    }
+    
+    if (uart_irq_rx_ready(dev)) {
+        uart_io_rx_isr(dev);
+    }
+    
+    if (uart_irq_tx_ready(dev)) {
+        uart_io_tx_isr(dev);
+    }
+}
+
+int uart_io_init(const struct device *dev)
+{
+    int ret;
+    
+    uart_io_dev = dev;
+    
+    ret = uart_irq_callback_user_data_set(dev, uart_cb, NULL);
+    if (ret < 0) {
+        return ret;
+    }
+    uart_irq_rx_enable(dev);
+    
+    return 0;
+}
+
+uint32_t uart_io_read(uint8_t *buf, uint32_t size, k_timeout_t timeout)
+{
+    uint32_t len = ring_buf_get(&uart_rx_ring, buf, size);
+    
+    if (len == 0 && k_sem_take(&uart_rx_sem, timeout) == 0) {
+        len = ring_buf_get(&uart_rx_ring, buf, size);
+    }
+    
+    return len;
+}
+
+int uart_io_write(const uint8_t *data, uint32_t len)
+{
+    k_spinlock_key_t key = k_spin_lock(&uart_tx_lock);
+    
+    if (ring_buf_space_get(&uart_tx_ring) < len) {
+        uart_stats.tx_dropped += len;
+        k_spin_unlock(&uart_tx_lock, key);
+        return -ENOSPC;
+    }
+    
+    ring_buf_put(&uart_tx_ring, data, len);
+    uart_stats.tx_bytes += len;
+    k_spin_unlock(&uart_tx_lock, key);
+    
+    // A interrupção de TX é desligada quando o buffer esvazia; religa a cada escrita:
+    uart_irq_tx_enable(uart_io_dev);
+    
+    return 0;
+}
+
+void uart_io_send_buf(struct uart_buf *buf)
+{
+    k_fifo_put(&uart_tx_fifo, buf);
+    uart_stats.tx_bufs++;
+    uart_stats.tx_bytes += buf->len;
+    uart_irq_tx_enable(uart_io_dev);
+}
+
+void uart_io_printf(const char *fmt, ...)
+{
+    char line[UART_IO_LINE_MAX];
+    va_list ap;
+    int len;
+    
+    va_start(ap, fmt);
+    len = vsnprintk(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    
+    if (len <= 0) {
+        return;
+    }
+    
+    uart_io_write((const uint8_t *)line, MIN(len, (int)sizeof(line) - 1));
+}
+
+void uart_io_stats_get(struct uart_io_stats *stats)
+{
+    *stats = uart_stats;
+}
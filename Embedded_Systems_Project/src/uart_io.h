@@ -0,0 +1,42 @@
+#ifndef UART_IO_H
+#define UART_IO_H
+
+#include "config.h"
+
+// Estatísticas da UART por interrupção:
+struct uart_io_stats {
+    uint32_t rx_overruns;  // Bytes recebidos descartados com o buffer de RX cheio
+    uint32_t tx_bytes;     // Bytes enfileirados para transmissão
+    uint32_t tx_dropped;   // Bytes descartados com o buffer de TX cheio
+    uint32_t tx_bufs;      // Buffers enviados por uart_io_send_buf
+};
+
+// Buffer transmitido sem cópia: alocado de um pool (APP_POOL_DEFINE), preenchido
+// e entregue a uart_io_send_buf, que o devolve ao pool ao fim da transmissão.
+struct uart_buf {
+    void *fifo_reserved;     // Uso interno da k_fifo
+    struct k_mem_slab *slab; // Pool de origem
+    uint16_t len;
+    uint8_t data[];
+};
+
+// Registra o callback da UART e habilita a recepção:
+int uart_io_init(const struct device *dev);
+
+// Copia até size bytes recebidos, aguardando até timeout se não houver nenhum:
+uint32_t uart_io_read(uint8_t *buf, uint32_t size, k_timeout_t timeout);
+
+// Enfileira dados para transmissão pela interrupção de TX, sem bloquear.
+// A escrita é tudo ou nada: sem espaço suficiente, os dados são descartados e contados.
+int uart_io_write(const uint8_t *data, uint32_t len);
+
+// Transfere o buffer para a interrupção de TX. Ele é enviado inteiro, sem
+// intercalar com texto, e liberado no pool pela própria interrupção.
+void uart_io_send_buf(struct uart_buf *buf);
+
+// Formata e enfileira texto para transmissão (equivalente não bloqueante do printk):
+void uart_io_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+void uart_io_stats_get(struct uart_io_stats *stats);
+
+#endif /* UART_IO_H */